@@ -0,0 +1,49 @@
+#include "Bench.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replace the global allocation functions to keep track of live heap bytes.
+// Each block is prefixed with a header holding its size.
+
+namespace {
+    constexpr std::size_t HEADER = alignof(std::max_align_t);
+
+    std::atomic<std::size_t> g_live { 0 };
+    std::atomic<std::size_t> g_count { 0 };
+
+    void* allocate(std::size_t size)
+    {
+        auto* block = static_cast<unsigned char*>(std::malloc(size + HEADER));
+        if (block == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        *reinterpret_cast<std::size_t*>(block) = size;
+        g_live.fetch_add(size, std::memory_order_relaxed);
+        g_count.fetch_add(1, std::memory_order_relaxed);
+        return block + HEADER;
+    }
+
+    void release(void* ptr) noexcept
+    {
+        if (ptr == nullptr)
+        {
+            return;
+        }
+        auto* block = static_cast<unsigned char*>(ptr) - HEADER;
+        g_live.fetch_sub(*reinterpret_cast<std::size_t*>(block), std::memory_order_relaxed);
+        std::free(block);
+    }
+}
+
+std::size_t Bench::liveBytes() { return g_live.load(std::memory_order_relaxed); }
+
+std::size_t Bench::allocations() { return g_count.load(std::memory_order_relaxed); }
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void operator delete(void* ptr) noexcept { release(ptr); }
+void operator delete[](void* ptr) noexcept { release(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { release(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { release(ptr); }
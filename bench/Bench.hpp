@@ -0,0 +1,42 @@
+#ifndef REDUCXX_BENCH_HPP
+#define REDUCXX_BENCH_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+/**
+ * @brief Minimal helpers shared by the micro-benchmarks: a global allocation
+ * counter (see AllocCounter.cpp) and a wall-clock timer.
+ */
+namespace Bench {
+
+    //! Bytes currently allocated through the global operator new
+    std::size_t liveBytes();
+
+    //! Number of calls to the global operator new since program start
+    std::size_t allocations();
+
+    //! Run @a op @a iterations times and return the average nanoseconds per call
+    template <class F>
+    double nsPerOp(std::size_t iterations, F&& op)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            op(i);
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(iterations);
+    }
+
+    //! Prevent the optimizer from discarding @a value
+    template <class T>
+    inline void keep(const T& value)
+    {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+} // namespace Bench
+
+#endif //REDUCXX_BENCH_HPP
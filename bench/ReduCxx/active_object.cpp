@@ -0,0 +1,150 @@
+#include <Bench.hpp>
+#include <ReduCxx/Async/ActiveObject.hpp>
+#include <ReduCxx/Async/MpscQueue.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+using namespace ReduCxx;
+
+// Contention of many producer threads feeding a single consumer: the
+// lock-free queue behind ActiveObject against a mutex-protected std::queue
+// signalling a condition variable per element (ActiveObject's former
+// backend), then ActiveObject::post and postDetached end to end.
+// Usage: ReduCppBenchActiveObject [items per producer]
+
+namespace {
+
+    //! The former ActiveObject queue, as a baseline
+    class LockedQueue
+    {
+      public:
+        void push(long value)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_queue.push(value);
+            }
+            m_available.notify_one();
+        }
+
+        long pop()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_available.wait(lock, [this]() { return !m_queue.empty(); });
+            long value = m_queue.front();
+            m_queue.pop();
+            return value;
+        }
+
+      private:
+        std::queue<long> m_queue;
+        std::mutex m_mutex;
+        std::condition_variable m_available;
+    };
+
+    class LockFreeQueue
+    {
+      public:
+        void push(long value) { m_queue.push(std::move(value)); }
+
+        long pop()
+        {
+            for (;;)
+            {
+                if (std::optional<long> value = m_queue.pop())
+                {
+                    return *value;
+                }
+                std::this_thread::yield();
+            }
+        }
+
+      private:
+        _impl::MpscQueue<long> m_queue;
+    };
+
+    template <class Queue>
+    double queueNsPerItem(std::size_t producers, std::size_t items)
+    {
+        Queue queue;
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (std::size_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&queue, items]() {
+                for (std::size_t i = 0; i < items; ++i)
+                {
+                    queue.push(static_cast<long>(i));
+                }
+            });
+        }
+        long sum = 0;
+        for (std::size_t i = 0; i < producers * items; ++i)
+        {
+            sum += queue.pop();
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        Bench::keep(sum);
+        return elapsed.count() / static_cast<double>(producers * items);
+    }
+
+    template <bool Detached>
+    double postNsPerJob(std::size_t producers, std::size_t items)
+    {
+        ActiveObject<void> worker;
+        std::atomic<long> done { 0 };
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (std::size_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&worker, &done, items]() {
+                for (std::size_t i = 1; i < items; ++i)
+                {
+                    if constexpr (Detached)
+                    {
+                        worker.postDetached([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+                    }
+                    else
+                    {
+                        worker.post([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+                    }
+                }
+                worker.post([&done]() { done.fetch_add(1, std::memory_order_relaxed); }).get();
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        worker.post([]() {}).get();
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(producers * items);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t items = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+    std::printf("%-10s %14s %16s %14s %14s\n", "producers", "locked ns/op", "lock-free ns/op", "post ns/op",
+                "detached ns/op");
+    for (std::size_t producers : { 1, 2, 4, 8, 16, 32 })
+    {
+        const std::size_t perProducer = items / producers;
+        std::printf("%-10zu %14.1f %16.1f %14.1f %14.1f\n", producers,
+                    queueNsPerItem<LockedQueue>(producers, perProducer),
+                    queueNsPerItem<LockFreeQueue>(producers, perProducer),
+                    postNsPerJob<false>(producers, perProducer),
+                    postNsPerJob<true>(producers, perProducer));
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <Bench.hpp>
+#include <ReduCxx/Async/ActiveObject.hpp>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace ReduCxx;
+
+// Producers outrunning the worker of an ActiveObject: memory held by the
+// queue (pooled nodes, measured once drained) and jobs shed, for an unbounded
+// queue and for a bounded one under each overflow policy.
+// Usage: ReduCppBenchBackpressure [jobs per producer] [work per job] [capacity]
+
+namespace {
+
+    volatile long g_sink = 0;
+
+    struct Result
+    {
+        double nsPerPost;
+        double totalMs;
+        std::size_t kib;
+        std::uint64_t rejected;
+    };
+
+    template <class Post>
+    Result run(const QueuePolicy& policy, std::size_t producers, std::size_t jobs, std::size_t work, Post&& post)
+    {
+        const std::size_t before = Bench::liveBytes();
+        Result result {};
+        {
+            ActiveObject<void> worker(policy);
+            auto op = [work]() {
+                long sum = 0;
+                for (std::size_t i = 0; i < work; ++i)
+                {
+                    sum += static_cast<long>(i);
+                }
+                g_sink = sum;
+            };
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads;
+            for (std::size_t p = 0; p < producers; ++p)
+            {
+                threads.emplace_back([&]() {
+                    for (std::size_t i = 0; i < jobs; ++i)
+                    {
+                        post(worker, op);
+                    }
+                });
+            }
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+            std::chrono::duration<double, std::nano> produced = std::chrono::steady_clock::now() - start;
+            worker.postUnbounded([]() {}, Priority::LOW).get();
+            std::chrono::duration<double, std::milli> total = std::chrono::steady_clock::now() - start;
+            result.nsPerPost = produced.count() / static_cast<double>(producers * jobs);
+            result.totalMs = total.count();
+            result.kib = (Bench::liveBytes() - before) / 1024;
+            result.rejected = worker.rejected();
+        }
+        return result;
+    }
+
+    void print(const char* name, const Result& result)
+    {
+        std::printf("%-14s %12.1f %12.1f %12zu %12llu\n", name, result.nsPerPost, result.totalMs, result.kib,
+                    static_cast<unsigned long long>(result.rejected));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t jobs = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    const std::size_t work = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200;
+    const std::size_t capacity = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1024;
+    const std::size_t producers = 4;
+
+    auto post = [](ActiveObject<void>& worker, auto& op) { worker.postDetached(op); };
+    auto tryPost = [](ActiveObject<void>& worker, auto& op) { worker.tryPostDetached(op); };
+    using Overflow = QueuePolicy::Overflow;
+
+    std::printf("%zu producers x %zu jobs, capacity %zu\n", producers, jobs, capacity);
+    std::printf("%-14s %12s %12s %12s %12s\n", "queue", "ns/post", "total ms", "queue KiB", "rejected");
+    print("unbounded", run(QueuePolicy::unbounded(), producers, jobs, work, post));
+    print("block", run(QueuePolicy::bounded(capacity, Overflow::BLOCK), producers, jobs, work, post));
+    print("tryPost", run(QueuePolicy::bounded(capacity, Overflow::FAIL), producers, jobs, work, tryPost));
+    print("drop oldest", run(QueuePolicy::bounded(capacity, Overflow::DROP_OLDEST), producers, jobs, work, post));
+    print("drop newest", run(QueuePolicy::bounded(capacity, Overflow::DROP_NEWEST), producers, jobs, work, post));
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include <Bench.hpp>
+#include <ReduCxx/StoreFactory.hpp>
+#include <cstdlib>
+#include <vector>
+
+using namespace ReduCxx;
+
+// Throughput of bursts of actions dispatched one by one versus as a batch,
+// for an increasing number of subscribers.
+// Usage: ReduCppBenchBatch [actions] [burst]
+
+namespace {
+
+    struct Tick
+    {
+        long price;
+    };
+
+    struct Book
+    {
+        long last = 0;
+        long volume = 0;
+    };
+
+    template <bool Batch>
+    double run(std::size_t subscribers, std::size_t actions, std::size_t burst)
+    {
+        auto store = StoreFactory<Tick>::make(HistoryPolicy::bounded(1), [](Book& book, const Tick& tick) {
+            book.last = tick.price;
+            ++book.volume;
+        });
+        long seen = 0;
+        for (std::size_t i = 0; i < subscribers; ++i)
+        {
+            store.subscribe([&seen, &store]() { seen += std::get<0>(store.state()).last; });
+        }
+
+        std::vector<Tick> ticks(burst);
+        double ns = Bench::nsPerOp(actions / burst, [&](std::size_t i) {
+            for (std::size_t j = 0; j < burst; ++j)
+            {
+                ticks[j].price = static_cast<long>(i + j);
+            }
+            if constexpr (Batch)
+            {
+                store.dispatchBatch(ticks.begin(), ticks.end());
+            }
+            else
+            {
+                for (const Tick& tick : ticks)
+                {
+                    store.dispatch(tick);
+                }
+            }
+        });
+        Bench::keep(seen);
+        return ns / static_cast<double>(burst);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t actions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000000;
+    const std::size_t burst = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 256;
+
+    std::printf("%-12s %14s %14s\n", "subscribers", "single ns/act", "batch ns/act");
+    for (std::size_t subscribers : { 0, 1, 10, 100 })
+    {
+        std::printf("%-12zu %14.2f %14.2f\n", subscribers, run<false>(subscribers, actions, burst),
+                    run<true>(subscribers, actions, burst));
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include <Bench.hpp>
+#include <ReduCxx/StoreFactory.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace ReduCxx;
+
+// Throughput of an AsyncStore fed by bursting producer threads, reducing
+// each action on its own versus coalescing the queued ones.
+// Usage: ReduCppBenchCoalesced [actions per producer] [subscribers]
+
+namespace {
+
+    struct Counter
+    {
+        long value = 0;
+    };
+
+    struct Result
+    {
+        double nsPerAction;
+        double notificationsPerAction;
+    };
+
+    Result run(const DispatchPolicy& policy, std::size_t producers, std::size_t actions, std::size_t subscribers)
+    {
+        auto store = StoreFactory<int>::makeAsync(policy, [](Counter& state, const int& action) {
+            state.value += action;
+        });
+        std::atomic<long> notifications { 0 };
+        for (std::size_t i = 0; i < subscribers; ++i)
+        {
+            store.subscribeSync([&notifications]() { notifications.fetch_add(1, std::memory_order_relaxed); });
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (std::size_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&store, actions]() {
+                for (std::size_t i = 1; i < actions; ++i)
+                {
+                    store.dispatch(1);
+                }
+                store.dispatch(1).get();
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        store.dispatch(0).get();
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        const double total = static_cast<double>(producers * actions);
+        return { elapsed.count() / total, static_cast<double>(notifications.load()) / total };
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t actions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const std::size_t subscribers = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10;
+
+    std::printf("%-10s %12s %12s %12s %12s\n", "producers", "seq ns/op", "seq notif", "coal ns/op", "coal notif");
+    for (std::size_t producers : { 1, 2, 4, 8 })
+    {
+        Result sequential = run(DispatchPolicy::sequential(), producers, actions, subscribers);
+        Result coalesced = run(DispatchPolicy::coalesced(), producers, actions, subscribers);
+        std::printf("%-10zu %12.1f %12.3f %12.1f %12.3f\n", producers, sequential.nsPerAction,
+                    sequential.notificationsPerAction, coalesced.nsPerAction, coalesced.notificationsPerAction);
+    }
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include <Bench.hpp>
+#include <ReduCxx/StoreFactory.hpp>
+#include <cstdlib>
+
+using namespace ReduCxx;
+
+// Heap allocations per action dispatched to an AsyncStore once its pools have
+// grown, for future-returning and detached dispatches.
+// Usage: ReduCppBenchDispatchAlloc [actions]
+
+namespace {
+
+    struct Counter
+    {
+        long value = 0;
+    };
+
+    struct Result
+    {
+        double nsPerAction;
+        double allocationsPerAction;
+    };
+
+    template <class Store, class F>
+    Result measure(Store& store, std::size_t actions, F&& dispatch)
+    {
+        // the first round grows the queue and promise pools to their peak size
+        Result result {};
+        for (int round = 0; round < 2; ++round)
+        {
+            const std::size_t before = Bench::allocations();
+            result.nsPerAction = Bench::nsPerOp(actions, [&](std::size_t) { dispatch(store); });
+            store.dispatch(0).get();
+            result.allocationsPerAction = static_cast<double>(Bench::allocations() - before) / static_cast<double>(actions);
+        }
+        return result;
+    }
+
+    template <class F>
+    void run(const char* name, const DispatchPolicy& policy, std::size_t actions, F&& dispatch)
+    {
+        auto store = StoreFactory<int>::makeAsync(policy, [](Counter& state, const int& action) {
+            state.value += action;
+        });
+        Result result = measure(store, actions, dispatch);
+        std::printf("%-24s %12.1f %12.4f\n", name, result.nsPerAction, result.allocationsPerAction);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t actions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+
+    auto withFuture = [](auto& store) { Bench::keep(store.dispatch(1)); };
+    auto detached = [](auto& store) { store.dispatchDetached(1); };
+
+    std::printf("%-24s %12s %12s\n", "dispatch", "ns/op", "allocs/op");
+    run("sequential future", DispatchPolicy::sequential(), actions, withFuture);
+    run("sequential detached", DispatchPolicy::sequential(), actions, detached);
+    run("coalesced future", DispatchPolicy::coalesced(), actions, withFuture);
+    run("coalesced detached", DispatchPolicy::coalesced(), actions, detached);
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <Bench.hpp>
+#include <ReduCxx/StoreFactory.hpp>
+#include <cstdlib>
+#include <list>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace ReduCxx;
+
+// Delivery of state changes to many async subscribers, each one running on a
+// dedicated ActiveObject (one thread per subscriber) versus on a strand of a
+// thread pool sized to the cores.
+// Usage: ReduCppBenchFanOut [actions] [work per notification]
+
+namespace {
+
+    struct Counter
+    {
+        long value = 0;
+    };
+
+    volatile long g_sink = 0;
+
+    void work(std::size_t amount)
+    {
+        long sum = 0;
+        for (std::size_t i = 0; i < amount; ++i)
+        {
+            sum += static_cast<long>(i);
+        }
+        g_sink = sum;
+    }
+
+    template <class Subscribe>
+    double run(std::size_t subscribers, std::size_t actions, Subscribe&& subscribe)
+    {
+        auto store = StoreFactory<int>::makeAsync([](Counter& state, const int& action) { state.value += action; });
+        std::vector<std::shared_ptr<SubscriptionHandle>> handles;
+        for (std::size_t s = 0; s < subscribers; ++s)
+        {
+            handles.push_back(subscribe(store, s));
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 1; i < actions; ++i)
+        {
+            store.dispatchDetached(1);
+        }
+        store.dispatch(1).get();
+        for (const std::shared_ptr<SubscriptionHandle>& handle : handles)
+        {
+            handle->waitAll();
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(actions * subscribers);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t actions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    const std::size_t amount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200;
+    auto op = [amount]() { work(amount); };
+
+    ThreadPool pool;
+    std::printf("pool of %zu threads\n", pool.size());
+    std::printf("%-12s %18s %18s\n", "subscribers", "active ns/notif", "pool ns/notif");
+    for (std::size_t subscribers : { 4, 16, 64 })
+    {
+        std::list<ActiveObject<void>> workers;
+        const double dedicated = run(subscribers, actions, [&](auto& store, std::size_t) {
+            workers.emplace_back();
+            return store.subscribeAsync(workers.back(), op);
+        });
+        const double pooled = run(subscribers, actions, [&](auto& store, std::size_t) {
+            return store.subscribeAsync(pool, op);
+        });
+        std::printf("%-12zu %18.1f %18.1f\n", subscribers, dedicated, pooled);
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include <Bench.hpp>
+#include <ReduCxx/Store.hpp>
+#include <array>
+#include <cstdlib>
+
+using namespace ReduCxx;
+
+// Steady-state memory and dispatch latency of a Store for different history
+// retention policies. Usage: ReduCppBenchHistory [actions]
+
+namespace {
+
+    struct State
+    {
+        long counter = 0;
+        std::array<long, 7> payload {};
+    };
+
+    struct Increment { };
+
+    State reduce(const State& state, const Increment&)
+    {
+        State next = state;
+        ++next.counter;
+        return next;
+    }
+
+    void run(const char* name, const HistoryPolicy& policy, std::size_t actions)
+    {
+        std::size_t before = Bench::liveBytes();
+        {
+            Store<State, Increment> store(reduce, policy);
+            const std::size_t window = actions / 10;
+
+            double first = Bench::nsPerOp(window, [&](std::size_t) { store.dispatch({}); });
+            Bench::nsPerOp(actions - 2 * window, [&](std::size_t) { store.dispatch({}); });
+            double last = Bench::nsPerOp(window, [&](std::size_t) { store.dispatch({}); });
+            Bench::keep(store.state());
+
+            std::printf("%-16s %10zu actions  first 10%%: %7.1f ns/op  last 10%%: %7.1f ns/op  resident: %12zu bytes\n",
+                        name, actions, first, last, Bench::liveBytes() - before);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t actions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+
+    run("bounded(1)", HistoryPolicy::bounded(1), actions);
+    run("bounded(64)", HistoryPolicy::bounded(64), actions);
+    run("bounded(4096)", HistoryPolicy::bounded(4096), actions);
+    run("unbounded", HistoryPolicy::unbounded(), actions);
+    run("events(64,4096)", HistoryPolicy::eventSourced(64, 4096), actions);
+    run("events(64)", HistoryPolicy::eventSourced(64), actions);
+    return 0;
+}
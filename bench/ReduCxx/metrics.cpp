@@ -0,0 +1,56 @@
+#include <Bench.hpp>
+#include <ReduCxx/StoreFactory.hpp>
+#include <cstdlib>
+
+using namespace ReduCxx;
+
+// Cost of the dispatch instrumentation: the same detached and synchronized
+// dispatches, built once with REDUCXX_METRICS (ReduCppBenchMetrics) and once
+// without (ReduCppBenchNoMetrics), then the latencies recorded, if any.
+// Usage: ReduCppBenchMetrics [actions]
+
+namespace {
+
+    void print(const char* name, const LatencyHistogram& histogram)
+    {
+        std::printf("%-14s %10llu %10lld %10lld %10lld %10lld\n", name,
+                    static_cast<unsigned long long>(histogram.count()),
+                    static_cast<long long>(histogram.mean().count()),
+                    static_cast<long long>(histogram.percentile(50).count()),
+                    static_cast<long long>(histogram.percentile(99).count()),
+                    static_cast<long long>(histogram.max().count()));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t actions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+    auto store = StoreFactory<int>::makeAsync([](long& state, const int& action) { state += action; });
+    int notified = 0;
+    store.subscribeSync([&notified]() { ++notified; });
+    store.dispatch(1).get();
+
+    const double detached = Bench::nsPerOp(actions, [&](std::size_t) { store.dispatchDetached(1); });
+    store.dispatch(1).get();
+    const double synchronized = Bench::nsPerOp(actions / 10, [&](std::size_t) { store.dispatch(1).get(); });
+    Bench::keep(notified);
+
+    std::printf("metrics %s, %zu actions\n", METRICS_ENABLED ? "compiled in" : "compiled out", actions);
+    std::printf("%-24s %12s\n", "dispatch", "ns/action");
+    std::printf("%-24s %12.1f\n", "detached (producer)", detached);
+    std::printf("%-24s %12.1f\n", "dispatch + get", synchronized);
+    if (!METRICS_ENABLED)
+    {
+        return 0;
+    }
+
+    const DispatchMetrics metrics = store.metrics();
+    std::printf("\n%-14s %10s %10s %10s %10s %10s\n", "latency", "count", "mean ns", "p50 ns", "p99 ns", "max ns");
+    print("queue wait", metrics.queueWait);
+    print("reduce", metrics.reduce);
+    print("subscriptions", metrics.subscriptions);
+    print("total", metrics.total);
+    std::printf("queue high-water mark %zu\n", metrics.queue.highWater);
+    return 0;
+}
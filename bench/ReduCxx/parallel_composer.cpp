@@ -0,0 +1,68 @@
+#include <Bench.hpp>
+#include <ReduCxx/StoreFactory.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using namespace ReduCxx;
+
+// Dispatch cost of a composite Store made of 8 CPU-heavy reducers (each one
+// rebuilding a sorted index), run one after the other by the Composer or
+// concurrently by a ParallelComposer.
+// Usage: ReduCppBenchParallelComposer [dispatches] [index size]
+
+namespace {
+
+    template <int Salt>
+    struct Index
+    {
+        std::vector<unsigned> keys;
+    };
+
+    template <int Salt>
+    struct Rebuild
+    {
+        std::size_t size;
+
+        Index<Salt> operator()(const Index<Salt>&, const int& action) const
+        {
+            Index<Salt> next;
+            next.keys.resize(size);
+            unsigned seed = static_cast<unsigned>(action * 7919 + Salt);
+            for (unsigned& key : next.keys)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                key = seed;
+            }
+            std::sort(next.keys.begin(), next.keys.end());
+            return next;
+        }
+    };
+
+    template <class Store>
+    double run(Store& store, std::size_t dispatches)
+    {
+        return Bench::nsPerOp(dispatches, [&](std::size_t i) { store.dispatch(static_cast<int>(i)); }) / 1000.0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t dispatches = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50;
+    const std::size_t size = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20000;
+
+    auto sequential = StoreFactory<int>::make(HistoryPolicy::bounded(1),
+        Rebuild<0>{ size }, Rebuild<1>{ size }, Rebuild<2>{ size }, Rebuild<3>{ size },
+        Rebuild<4>{ size }, Rebuild<5>{ size }, Rebuild<6>{ size }, Rebuild<7>{ size });
+
+    ThreadPool pool;
+    auto parallel = StoreFactory<int>::makeParallel(pool, HistoryPolicy::bounded(1),
+        Rebuild<0>{ size }, Rebuild<1>{ size }, Rebuild<2>{ size }, Rebuild<3>{ size },
+        Rebuild<4>{ size }, Rebuild<5>{ size }, Rebuild<6>{ size }, Rebuild<7>{ size });
+
+    std::printf("8 reducers sorting %zu keys, pool of %zu threads\n", size, pool.size());
+    std::printf("%-12s %12s\n", "composer", "us/dispatch");
+    std::printf("%-12s %12.1f\n", "sequential", run(sequential, dispatches));
+    std::printf("%-12s %12.1f\n", "parallel", run(parallel, dispatches));
+    return 0;
+}
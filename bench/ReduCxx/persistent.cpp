@@ -0,0 +1,68 @@
+#include <Bench.hpp>
+#include <ReduCxx/Store.hpp>
+#include <ReduCxx/Persistent/PersistentVector.hpp>
+#include <cstdlib>
+#include <vector>
+
+using namespace ReduCxx;
+
+// Memory retained per history step and dispatch latency of a state holding a
+// large vector, with a plain std::vector versus a PersistentVector.
+// Usage: ReduCppBenchPersistent [elements] [actions]
+
+namespace {
+
+    struct Set
+    {
+        std::size_t index;
+        long value;
+    };
+
+    template <class Vector>
+    void run(const char* name, const Vector& initial, std::size_t actions)
+    {
+        const std::size_t elements = initial.size();
+        Store<Vector, Set> store([&](const Vector& state, const Set& action) -> Vector {
+            if (state.empty())
+            {
+                return initial;
+            }
+            if constexpr (std::is_same_v<Vector, std::vector<long>>)
+            {
+                Vector next = state;
+                next[action.index] = action.value;
+                return next;
+            }
+            else
+            {
+                return state.set(action.index, action.value);
+            }
+        });
+        store.dispatch({ 0, 0 });
+
+        std::size_t before = Bench::liveBytes();
+        double ns = Bench::nsPerOp(actions, [&](std::size_t i) {
+            store.dispatch({ (i * 7919) % elements, long(i) });
+        });
+        std::size_t perStep = (Bench::liveBytes() - before) / actions;
+
+        std::printf("%-18s %8zu elements  %6zu actions  %10.1f ns/op  %9zu bytes/history step\n",
+                    name, elements, actions, ns, perStep);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t elements = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const std::size_t actions = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+
+    PersistentVector<long> persistent;
+    for (std::size_t i = 0; i < elements; ++i)
+    {
+        persistent = persistent.push_back(long(i));
+    }
+
+    run("std::vector", std::vector<long>(elements, 0), actions);
+    run("PersistentVector", persistent, actions);
+    return 0;
+}
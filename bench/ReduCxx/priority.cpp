@@ -0,0 +1,89 @@
+#include <Bench.hpp>
+#include <ReduCxx/StoreFactory.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using namespace ReduCxx;
+
+// Latency of a critical action dispatched behind a backlog of bulk updates,
+// with the NORMAL priority of the backlog or with a HIGH one, the lanes being
+// served strictly or by weight.
+// Usage: ReduCppBenchPriority [backlog] [work per action] [rounds]
+
+namespace {
+
+    struct Book
+    {
+        long volume = 0;
+        bool halted = false;
+    };
+
+    struct Order
+    {
+        long amount;    // 0 to halt
+    };
+
+    double run(const DispatchPolicy& policy, Priority priority, std::size_t backlog, std::size_t work,
+               std::size_t rounds, double& worst)
+    {
+        auto store = StoreFactory<Order>::makeAsync(policy, [work](Book& state, const Order& action) {
+            if (action.amount == 0)
+            {
+                state.halted = true;
+                return;
+            }
+            long sum = 0;
+            for (std::size_t i = 0; i < work; ++i)
+            {
+                sum += static_cast<long>(i) ^ action.amount;
+            }
+            state.volume += action.amount + (sum & 1);
+        });
+
+        std::vector<double> latencies;
+        for (std::size_t r = 0; r < rounds; ++r)
+        {
+            for (std::size_t i = 0; i < backlog; ++i)
+            {
+                store.dispatchDetached(Order { 1 });
+            }
+            auto start = std::chrono::steady_clock::now();
+            store.dispatch(Order { 0 }, priority).get();
+            std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+            latencies.push_back(elapsed.count());
+            store.dispatch(Order { 1 }).get();  // drain the backlog before the next round
+        }
+        std::sort(latencies.begin(), latencies.end());
+        worst = latencies.back();
+        return latencies[latencies.size() / 2];
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t backlog = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    const std::size_t work = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 500;
+    const std::size_t rounds = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 20;
+
+    std::printf("backlog of %zu actions, %zu rounds\n", backlog, rounds);
+    std::printf("%-24s %16s %16s\n", "critical action", "median us", "max us");
+    struct Case
+    {
+        const char* name;
+        DispatchPolicy policy;
+        Priority priority;
+    };
+    const Case cases[] = {
+        { "NORMAL", DispatchPolicy::sequential(), Priority::NORMAL },
+        { "HIGH, strict", DispatchPolicy::sequential(), Priority::HIGH },
+        { "HIGH, weighted 4:2:1", DispatchPolicy::sequential().withLanes(LanePolicy::weighted(4, 2, 1)), Priority::HIGH },
+    };
+    for (const Case& c : cases)
+    {
+        double worst = 0;
+        const double median = run(c.policy, c.priority, backlog, work, rounds, worst);
+        std::printf("%-24s %16.1f %16.1f\n", c.name, median, worst);
+    }
+    return 0;
+}
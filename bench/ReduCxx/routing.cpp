@@ -0,0 +1,73 @@
+#include <Bench.hpp>
+#include <ReduCxx/StoreFactory.hpp>
+#include <ReduCxx/Action.hpp>
+#include <cstdlib>
+
+using namespace ReduCxx;
+
+// Dispatch cost of a composite Store of 24 reducers, each one interested in a
+// single action type, with every reducer switching on Action::type() versus
+// compile-time routing via ReduCxx::handles().
+// Usage: ReduCppBenchRouting [actions]
+
+namespace {
+
+    constexpr int REDUCERS = 24;
+
+    class Event : public Action
+    {
+      public:
+        explicit Event(int type) : m_type(type) { }
+        [[nodiscard]] int type() const override { return m_type; }
+
+      private:
+        int m_type;
+    };
+
+    template <int I>
+    struct Slice
+    {
+        long value = 0;
+        long payload[7] {};
+    };
+
+    template <int I>
+    Slice<I> reduce(const Slice<I>& state, const Event& event)
+    {
+        switch (event.type())
+        {
+            case I:
+            {
+                Slice<I> next = state;
+                ++next.value;
+                return next;
+            }
+            default:
+                return state;
+        }
+    }
+
+    template <class Store>
+    void run(const char* name, Store& store, std::size_t actions)
+    {
+        double ns = Bench::nsPerOp(actions, [&](std::size_t i) { store.dispatch(Event(int((i * 7) % REDUCERS))); });
+        Bench::keep(store.state());
+        std::printf("%-8s %2d reducers  %8zu actions  %8.1f ns/op\n", name, REDUCERS, actions, ns);
+    }
+
+    template <int... Is>
+    void compare(std::integer_sequence<int, Is...>, std::size_t actions)
+    {
+        auto plain = StoreFactory<Event>::make(HistoryPolicy::bounded(1), reduce<Is>...);
+        auto routed = StoreFactory<Event>::make(HistoryPolicy::bounded(1), handles<Is>(reduce<Is>)...);
+        run("switch", plain, actions);
+        run("routed", routed, actions);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t actions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    compare(std::make_integer_sequence<int, REDUCERS>{}, actions);
+    return 0;
+}
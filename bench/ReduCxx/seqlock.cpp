@@ -0,0 +1,80 @@
+#include <Bench.hpp>
+#include <ReduCxx/Async/AsyncStore.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace ReduCxx;
+
+// Read throughput of an AsyncStore of small trivially copyable counters while
+// its reducers thread keeps dispatching: seqlock copies through state()
+// versus copies out of the shared snapshot.
+// Usage: ReduCppBenchSeqlock [milliseconds per run]
+
+namespace {
+
+    struct Counters
+    {
+        long values[4] = {};
+    };
+
+    template <class Store, class F>
+    double run(Store& store, std::size_t readers, std::chrono::milliseconds duration, F&& read)
+    {
+        std::atomic<bool> done { false };
+        std::atomic<std::size_t> reads { 0 };
+        std::vector<std::thread> threads;
+        for (std::size_t r = 0; r < readers; ++r)
+        {
+            threads.emplace_back([&]() {
+                std::size_t count = 0;
+                while (!done.load(std::memory_order_relaxed))
+                {
+                    read(store);
+                    ++count;
+                }
+                reads += count;
+            });
+        }
+        std::thread writer([&]() {
+            while (!done.load(std::memory_order_relaxed))
+            {
+                store.dispatch(1).get();
+            }
+        });
+        std::this_thread::sleep_for(duration);
+        done = true;
+        writer.join();
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        return static_cast<double>(reads.load()) / (static_cast<double>(duration.count()) * 1000.0);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::chrono::milliseconds duration(argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500);
+
+    AsyncStore<Counters, long> store([](const Counters& state, const long& action) {
+        Counters next = state;
+        for (long& value : next.values)
+        {
+            value += action;
+        }
+        return next;
+    });
+
+    auto bySeqlock = [](auto& store) { Bench::keep(store.state()); };
+    auto bySnapshot = [](auto& store) { Bench::keep(Counters(*store.snapshot())); };
+
+    std::printf("%-10s %16s %16s\n", "readers", "seqlock Mreads/s", "snap Mreads/s");
+    for (std::size_t readers : { 1, 2, 4, 8 })
+    {
+        std::printf("%-10zu %16.2f %16.2f\n", readers, run(store, readers, duration, bySeqlock),
+                    run(store, readers, duration, bySnapshot));
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <Bench.hpp>
+#include <ReduCxx/StoreFactory.hpp>
+#include <cstdlib>
+#include <map>
+#include <thread>
+#include <vector>
+
+using namespace ReduCxx;
+
+// Throughput of per-account updates fed by several producers, reduced by a
+// ShardedAsyncStore of 1 to 8 shards (1 shard being a plain AsyncStore).
+// Usage: ReduCppBenchSharded [actions per producer] [work per action]
+
+namespace {
+
+    struct Deposit
+    {
+        int account;
+        long amount;
+    };
+
+    using Balances = std::map<int, long>;
+
+    double run(std::size_t shards, std::size_t producers, std::size_t actions, std::size_t work)
+    {
+        auto store = StoreFactory<Deposit>::makeSharded(
+            [](const Deposit& action) { return action.account; }, shards,
+            [work](Balances& state, const Deposit& action) {
+                long sum = 0;
+                for (std::size_t i = 0; i < work; ++i)
+                {
+                    sum += static_cast<long>(i) ^ action.amount;
+                }
+                state[action.account] += action.amount + (sum & 1);
+            });
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (std::size_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&store, p, actions]() {
+                for (std::size_t i = 0; i < actions; ++i)
+                {
+                    store.dispatchDetached(Deposit { static_cast<int>(i * 31 + p) % 1024, 1 });
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        store.snapshot();   // waits for every shard
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(producers * actions);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t actions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    const std::size_t work = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 500;
+
+    std::printf("%u hardware threads, 4 producers\n", std::thread::hardware_concurrency());
+    std::printf("%-8s %12s\n", "shards", "ns/action");
+    for (std::size_t shards : { 1, 2, 4, 8 })
+    {
+        std::printf("%-8zu %12.1f\n", shards, run(shards, 4, actions, work));
+    }
+    return 0;
+}
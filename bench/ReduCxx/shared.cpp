@@ -0,0 +1,73 @@
+#include <Bench.hpp>
+#include <ReduCxx/StoreFactory.hpp>
+#include <cstdlib>
+#include <optional>
+#include <vector>
+
+using namespace ReduCxx;
+
+// Dispatch cost of a composite state made of 12 sub-states, each action
+// touching only one of them, with plain sub-states versus Shared boxes.
+// Usage: ReduCppBenchShared [actions]
+
+namespace {
+
+    struct Touch
+    {
+        int slice;
+    };
+
+    template <int I>
+    struct Slice
+    {
+        std::vector<int> values = std::vector<int>(1000, 0);
+    };
+
+    template <int I>
+    Slice<I> plain(const Slice<I>& state, const Touch& action)
+    {
+        Slice<I> next = state;
+        if (action.slice == I)
+        {
+            ++next.values[0];
+        }
+        return next;
+    }
+
+    template <int I>
+    std::optional<Slice<I>> shared(const Slice<I>& state, const Touch& action)
+    {
+        if (action.slice != I)
+        {
+            return std::nullopt;
+        }
+        Slice<I> next = state;
+        ++next.values[0];
+        return next;
+    }
+
+    template <class Store>
+    void run(const char* name, Store& store, std::size_t actions)
+    {
+        std::size_t allocations = Bench::allocations();
+        double ns = Bench::nsPerOp(actions, [&](std::size_t i) { store.dispatch({ int(i % 12) }); });
+        std::printf("%-8s %8zu actions  %9.1f ns/op  %5.1f allocations/op\n",
+                    name, actions, ns, double(Bench::allocations() - allocations) / double(actions));
+    }
+
+    template <int... Is>
+    void compare(std::integer_sequence<int, Is...>, std::size_t actions)
+    {
+        auto plainStore = StoreFactory<Touch>::make(HistoryPolicy::bounded(1), plain<Is>...);
+        auto sharedStore = StoreFactory<Touch>::makeShared(HistoryPolicy::bounded(1), shared<Is>...);
+        run("plain", plainStore, actions);
+        run("shared", sharedStore, actions);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t actions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    compare(std::make_integer_sequence<int, 12>{}, actions);
+    return 0;
+}
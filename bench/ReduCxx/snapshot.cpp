@@ -0,0 +1,79 @@
+#include <Bench.hpp>
+#include <ReduCxx/StoreFactory.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace ReduCxx;
+
+// Read throughput of an AsyncStore while its reducers thread keeps
+// dispatching, reading by copy, by snapshot handle or through a StateReader.
+// Usage: ReduCppBenchSnapshot [milliseconds per run] [state size]
+
+namespace {
+
+    struct Big
+    {
+        std::vector<long> values;
+    };
+
+    template <class Store, class F>
+    double run(Store& store, std::size_t readers, std::chrono::milliseconds duration, F&& read)
+    {
+        std::atomic<bool> done { false };
+        std::atomic<std::size_t> reads { 0 };
+        std::vector<std::thread> threads;
+        for (std::size_t r = 0; r < readers; ++r)
+        {
+            threads.emplace_back([&]() {
+                auto reader = store.reader();
+                std::size_t count = 0;
+                while (!done.load(std::memory_order_relaxed))
+                {
+                    read(store, reader);
+                    ++count;
+                }
+                reads += count;
+            });
+        }
+        std::thread writer([&]() {
+            while (!done.load(std::memory_order_relaxed))
+            {
+                store.dispatch(1).get();
+            }
+        });
+        std::this_thread::sleep_for(duration);
+        done = true;
+        writer.join();
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        return static_cast<double>(reads.load()) / (static_cast<double>(duration.count()) * 1000.0);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::chrono::milliseconds duration(argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500);
+    const std::size_t size = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+
+    auto store = StoreFactory<int>::makeAsync([size](Big& state, const int& action) {
+        state.values.resize(size);
+        state.values.front() += action;
+    });
+    store.dispatch(0).get();
+
+    auto byCopy = [](auto& store, auto&) { Bench::keep(store.state()); };
+    auto bySnapshot = [](auto& store, auto&) { Bench::keep(store.snapshot()); };
+    auto byReader = [](auto&, auto& reader) { Bench::keep(reader.state()); };
+
+    std::printf("%-10s %14s %14s %14s\n", "readers", "copy Mreads/s", "snap Mreads/s", "reader Mreads/s");
+    for (std::size_t readers : { 1, 2, 4, 8 })
+    {
+        std::printf("%-10zu %14.2f %14.2f %14.2f\n", readers, run(store, readers, duration, byCopy),
+                    run(store, readers, duration, bySnapshot), run(store, readers, duration, byReader));
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include <Bench.hpp>
+#include <ReduCxx/StoreFactory.hpp>
+#include <cstdlib>
+
+using namespace ReduCxx;
+
+// Dispatch cost of trivial reducers through a type-erased Store (std::function)
+// versus a Store bound to the actual reducer type.
+// Usage: ReduCppBenchStaticReducer [actions]
+
+namespace {
+
+    struct Add
+    {
+        int value;
+    };
+
+    struct Counter
+    {
+        long value = 0;
+    };
+
+    struct Sum
+    {
+        long value = 0;
+    };
+
+    template <class Store>
+    void run(const char* name, Store& store, std::size_t actions)
+    {
+        double ns = Bench::nsPerOp(actions, [&](std::size_t i) { store.dispatch({ int(i & 7) }); });
+        Bench::keep(store.state());
+        std::printf("%-24s %9zu actions  %6.2f ns/op\n", name, actions, ns);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t actions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+
+    auto count = [](const Counter& state, const Add&) { return Counter { state.value + 1 }; };
+    auto sum = [](Sum& state, const Add& action) { state.value += action.value; };
+    auto composer = Reduce<Add>::with(count, sum);
+    using State = decltype(composer)::CompositeState;
+
+    Store<Counter, Add> erasedSingle(count, HistoryPolicy::bounded(1));
+    Store<Counter, Add, decltype(count)> staticSingle(count, HistoryPolicy::bounded(1));
+    Store<State, Add> erasedComposite(composer, HistoryPolicy::bounded(1));
+    auto staticComposite = StoreFactory<Add>::make(HistoryPolicy::bounded(1), count, sum);
+
+    run("erased, one reducer", erasedSingle, actions);
+    run("static, one reducer", staticSingle, actions);
+    run("erased, composite", erasedComposite, actions);
+    run("static, composite", staticComposite, actions);
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <Bench.hpp>
+#include <ReduCxx/StoreFactory.hpp>
+#include <cstdlib>
+#include <memory>
+
+using namespace ReduCxx;
+
+// A long-lived async subscription whose handle is never waited for: memory
+// its handle holds and allocations per notification when tracking every execution
+// with a future versus only counting them.
+// Usage: ReduCppBenchSubscriptionTracking [actions]
+
+namespace {
+
+    struct Result
+    {
+        double nsPerNotification;
+        double allocations;
+        std::size_t kib;
+    };
+
+    Result run(const TrackingPolicy& tracking, std::size_t actions)
+    {
+        ActiveObject<void> worker;
+        auto store = StoreFactory<int>::makeAsync([](long& state, const int& action) { state += action; });
+        std::shared_ptr<SubscriptionHandle> handle = store.subscribeAsync(worker, tracking, []() {});
+        store.dispatch(1).get();
+        worker.post([]() {}).get();
+
+        const std::size_t allocations = Bench::allocations();
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 1; i < actions; ++i)
+        {
+            store.dispatchDetached(1);
+        }
+        store.dispatch(1).get();
+        worker.post([]() {}).get();
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+        Result result;
+        result.nsPerNotification = elapsed.count() / static_cast<double>(actions);
+        result.allocations = static_cast<double>(Bench::allocations() - allocations) / static_cast<double>(actions);
+        const std::size_t bytes = Bench::liveBytes();
+        handle.reset();
+        result.kib = (bytes - Bench::liveBytes()) / 1024;
+        return result;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t actions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+    std::printf("%zu notifications, handle never waited for\n", actions);
+    std::printf("%-10s %16s %16s %16s\n", "tracking", "ns/notif", "allocs/notif", "held KiB");
+    const Result futures = run(TrackingPolicy::futures(), actions);
+    std::printf("%-10s %16.1f %16.2f %16zu\n", "futures", futures.nsPerNotification, futures.allocations, futures.kib);
+    const Result counters = run(TrackingPolicy::counters(), actions);
+    std::printf("%-10s %16.1f %16.2f %16zu\n", "counters", counters.nsPerNotification, counters.allocations, counters.kib);
+    return 0;
+}
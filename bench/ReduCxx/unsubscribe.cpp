@@ -0,0 +1,73 @@
+#include <Bench.hpp>
+#include <ReduCxx/StoreFactory.hpp>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using namespace ReduCxx;
+
+// Cost of dispatching to an AsyncStore whose async subscribers are alive or
+// had their handles released (hence removed at the first state change), and
+// cost of unsubscribing from a Store as the number of subscribers grows.
+// Usage: ReduCppBenchUnsubscribe [actions] [async subscribers]
+
+namespace {
+
+    double dispatch(std::size_t actions, std::size_t subscribers, bool release)
+    {
+        ActiveObject<void> worker;
+        auto store = StoreFactory<int>::makeAsync([](long& state, const int& action) { state += action; });
+        std::vector<std::shared_ptr<SubscriptionHandle>> handles;
+        for (std::size_t s = 0; s < subscribers; ++s)
+        {
+            handles.push_back(store.subscribeAsync(worker, TrackingPolicy::counters(), []() {}));
+        }
+        if (release)
+        {
+            handles.clear();
+        }
+        store.dispatch(1).get();
+        worker.post([]() {}).get();
+
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 1; i < actions; ++i)
+        {
+            store.dispatchDetached(1);
+        }
+        store.dispatch(1).get();
+        worker.post([]() {}).get();
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(actions);
+    }
+
+    double unsubscribe(std::size_t subscribers)
+    {
+        Store<long, int> store([](const long& state, const int& action) { return state + action; });
+        std::vector<Subscription> tokens;
+        for (std::size_t s = 0; s < subscribers; ++s)
+        {
+            tokens.push_back(store.subscribe([]() {}));
+        }
+        // remove the oldest first, the worst case for a vector of subscriptions
+        return Bench::nsPerOp(subscribers, [&](std::size_t i) { store.unsubscribe(tokens[i]); });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t actions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    const std::size_t subscribers = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 16;
+
+    std::printf("%zu actions, %zu async subscribers\n", actions, subscribers);
+    std::printf("%-20s %12s\n", "handles", "ns/action");
+    std::printf("%-20s %12.1f\n", "held", dispatch(actions, subscribers, false));
+    std::printf("%-20s %12.1f\n", "released", dispatch(actions, subscribers, true));
+    std::printf("%-20s %12.1f\n", "none", dispatch(actions, 0, false));
+
+    std::printf("\n%-20s %12s\n", "store subscribers", "ns/unsubscribe");
+    for (std::size_t count : { 100, 10000, 100000 })
+    {
+        std::printf("%-20zu %12.1f\n", count, unsubscribe(count));
+    }
+    return 0;
+}
@@ -2,8 +2,19 @@
 #define REDUCXX_ACTIVE_OBJECT_HPP
 
 #include "ExceptionHandlingError.hpp"
-#include <queue>
+#include "Metrics.hpp"
+#include "MpscQueue.hpp"
+#include "NodePool.hpp"
+#include "Priority.hpp"
+#include "QueueFullError.hpp"
+#include "QueuePolicy.hpp"
+#include "ReduCxx/InplaceFunction.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <mutex>
+#include <optional>
 #include <condition_variable>
 #include <thread>
 #include <future>
@@ -18,57 +29,170 @@ namespace ReduCxx
 
 /**
  * @brief A more or less canonical implementation of the Active Object pattern.
+ * Jobs are posted through a lock-free queue: producers never contend on a
+ * lock, unless the worker is parked waiting for work and must be woken up.
+ * Operations capturing up to 56 bytes are stored inline in pooled queue
+ * nodes and promises draw their shared state from a pool, so that posting
+ * does not allocate once the pools have grown to the peak load.
+ * Jobs are posted to one of the priority lanes, each one a queue of its own,
+ * served as told by the @a LanePolicy.
+ * The queue may be bounded, its @a QueuePolicy telling what happens to the
+ * jobs posted while it is full; @a tryPost never waits nor drops anything.
+ * With REDUCXX_METRICS the depth of the queue is tracked, see @a metrics.
  */
 template <class R>
 class ReduCxx::ActiveObject
 {
   public:
-    typedef std::function<R()> job_op;
+    typedef _impl::InplaceFunction<R(), 56> job_op;
+    typedef std::function<void(std::exception_ptr)> error_sink;
 
     struct job
     {
-        std::promise<R> promise;
+        std::optional<std::promise<R>> promise; // none for detached jobs
         job_op operation;
+        bool bounded = true;    // subject to the queue capacity
+#if REDUCXX_METRICS
+        std::chrono::steady_clock::time_point posted;
+#endif
         template <class F>
         explicit job(const F& operation) : operation(operation) { }
         template <class F>
         job(F&& operation) noexcept : operation(std::forward<F>(operation)) { }
-        job(job&& rhs) noexcept : promise(std::move(rhs.promise)), operation(std::move(rhs.operation)) { }
+        job(job&& rhs) noexcept
+            : promise(std::move(rhs.promise)), operation(std::move(rhs.operation)), bounded(rhs.bounded)
+#if REDUCXX_METRICS
+            , posted(rhs.posted)
+#endif
+        { }
         job(const job&) = delete;
         job& operator =(const job&) = delete;
     };
 
-    ActiveObject()
-        : m_worker(std::bind(&ActiveObject<R>::run, this)), m_quit(false)
+    explicit ActiveObject(const LanePolicy& lanes = LanePolicy::strict(),
+                          const QueuePolicy& queue = QueuePolicy::unbounded())
+        : m_promises(std::make_shared<_impl::BlockPool>())
+        , m_policy(lanes)
+        , m_queue(queue)
+        , m_quit(false), m_worker(std::bind(&ActiveObject<R>::run, this))
     { }
 
-    ActiveObject(ActiveObject&& temp) noexcept
-        : m_queue(std::move(temp.m_queue))
-        , m_worker(std::move(temp.m_worker))
-        , m_quit(false)
-    { }
+    explicit ActiveObject(const QueuePolicy& queue) : ActiveObject(LanePolicy::strict(), queue) { }
 
     ~ActiveObject();
 
+    // the worker runs on this very object: it can be neither copied nor moved
     ActiveObject(const ActiveObject&) = delete;
     ActiveObject& operator =(const ActiveObject&) = delete;
 
+    /**
+     * @brief Post given @a operation, returning a @a future for its result.
+     * If the queue is full, depending on its policy this waits for room,
+     * throws a QueueFullError, or drops a job: a dropped job never runs and
+     * its future holds a QueueFullError.
+     */
+    template <class F>
+    std::future<R> post(const F& operation, Priority priority = Priority::NORMAL);
+
     template <class F>
-    std::future<R> post(const F& operation);
+    std::future<R> post(F&& operation, Priority priority = Priority::NORMAL);
 
+    /**
+     * @brief Post given @a operation without any promise/future pair (hence
+     * without the allocation of their shared state): its result is dropped
+     * and its exceptions are passed to the error sink.
+     * A full queue is handled as by @a post, dropped jobs being only counted.
+     */
     template <class F>
-    std::future<R> post(F&& operation);
+    void postDetached(F&& operation, Priority priority = Priority::NORMAL);
+
+    /**
+     * @brief Post given @a operation only if the queue has room for it,
+     * whatever the policy: never waits, throws or drops another job.
+     * @return the future of the job, none if rejected
+     */
+    template <class F>
+    std::optional<std::future<R>> tryPost(F&& operation, Priority priority = Priority::NORMAL);
+
+    //! @brief Same as @a tryPost but for a detached job, return whether it was accepted
+    template <class F>
+    bool tryPostDetached(F&& operation, Priority priority = Priority::NORMAL);
+
+    /**
+     * @brief Same as @a post, but the job is not subject to the capacity of
+     * the queue: it is never rejected nor dropped. Meant for the few control
+     * jobs that others wait for.
+     */
+    template <class F>
+    std::future<R> postUnbounded(F&& operation, Priority priority = Priority::NORMAL);
+
+    //! @brief Number of jobs rejected or dropped so far because the queue was full
+    std::uint64_t rejected() const { return m_rejected.load(std::memory_order_relaxed); }
+
+    //! @brief Whether the calling thread is the worker, that is a job is calling
+    bool isWorker() const { return std::this_thread::get_id() == m_worker.get_id(); }
+
+    /**
+     * @brief Current and highest number of jobs queued, readable from any
+     * thread; always zero unless REDUCXX_METRICS is set.
+     */
+    QueueMetrics metrics() const
+    {
+#if REDUCXX_METRICS
+        return { m_depth.load(std::memory_order_relaxed), m_high_water.load(std::memory_order_relaxed) };
+#else
+        return {};
+#endif
+    }
+
+#if REDUCXX_METRICS
+    //! @brief When the running job was posted, from the worker only
+    std::chrono::steady_clock::time_point postedAt() const { return m_posted; }
+#endif
+
+    /**
+     * @brief Set the function receiving the exceptions thrown by detached
+     * jobs; it runs on the worker thread and shall not throw. Without a sink
+     * those exceptions are discarded.
+     */
+    void setErrorSink(error_sink sink);
 
     void shutdown();
 
   private:
-    std::queue<job> m_queue;
-    std::mutex m_mutex;
+    std::array<_impl::MpscQueue<job>, LanePolicy::LANES> m_lanes;
+    std::shared_ptr<_impl::BlockPool> m_promises;   // shared state of the promises
+    LanePolicy m_policy;
+    std::array<unsigned, LanePolicy::LANES> m_credits {};  // jobs each lane may still run in this round, worker only
+    QueuePolicy m_queue;
+    std::atomic<std::size_t> m_size { 0 };      // bounded jobs queued, when the queue is bounded
+    std::atomic<std::size_t> m_overdue { 0 };   // jobs for the worker to drop, in DROP_OLDEST mode
+    std::atomic<std::uint64_t> m_rejected { 0 };
+    std::atomic<std::size_t> m_blocked { 0 };   // producers waiting for room
+#if REDUCXX_METRICS
+    std::atomic<std::size_t> m_depth { 0 };
+    std::atomic<std::size_t> m_high_water { 0 };
+    std::chrono::steady_clock::time_point m_posted;     // of the running job, worker only
+#endif
+    std::mutex m_mutex;                 // to park and wake up the worker and blocked producers, and for the error sink
     std::condition_variable m_available;
+    std::condition_variable m_room;
+    std::atomic<bool> m_parked { false };
+    std::atomic<bool> m_quit;           // must be initialized before m_worker starts
+    error_sink m_error_sink;            // guarded by m_mutex
     std::thread m_worker;
-    bool m_quit;
 
     void run();
+    bool admit(bool wait);
+    bool reserve();
+    void release();
+    std::future<R> reject();
+    void enqueue(job&& j, Priority priority);
+    std::optional<job> shed();
+    std::optional<job> take();
+    bool empty() const;
+    void executeDetached(job& j);
+    void dequeued(const job& j);
 };
 
 template <class T>
@@ -76,11 +200,11 @@ static void execute(typename ReduCxx::ActiveObject<T>::job& j)
 {
     try
     {
-        j.promise.set_value(j.operation());
+        j.promise->set_value(j.operation());
     }
     catch (...)
     {
-        j.promise.set_exception(std::current_exception()); // this may throw
+        j.promise->set_exception(std::current_exception()); // this may throw
     }
 }
 
@@ -92,11 +216,11 @@ void execute<void>(typename ReduCxx::ActiveObject<void>::job& j)
     try
     {
         j.operation();
-        j.promise.set_value();
+        j.promise->set_value();
     }
     catch (...)
     {
-        j.promise.set_exception(std::current_exception()); // this may throw
+        j.promise->set_exception(std::current_exception()); // this may throw
     }
 }
 
@@ -115,56 +239,366 @@ void ReduCxx::ActiveObject<R>::shutdown()
         m_quit = true;
     }
     m_available.notify_one();
+    m_room.notify_all();
 }
 
 template <class R>
 template <class F>
-std::future<R> ReduCxx::ActiveObject<R>::post(const F& operation)
+std::future<R> ReduCxx::ActiveObject<R>::post(const F& operation, Priority priority)
 {
-    std::future<R> retv;
+    if (!admit(true))
     {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        m_queue.push(job(operation));
-        retv = m_queue.back().promise.get_future();
+        return reject();
     }
-    m_available.notify_one();
+    job j(operation);
+    std::future<R> retv = j.promise.emplace(std::allocator_arg, _impl::PoolAllocator<char>(m_promises)).get_future();
+    enqueue(std::move(j), priority);
     return retv;
 }
 
 template <class R>
 template <class F>
-std::future<R> ReduCxx::ActiveObject<R>::post(F&& operation)
+std::future<R> ReduCxx::ActiveObject<R>::post(F&& operation, Priority priority)
 {
-    std::future<R> retv;
+    if (!admit(true))
     {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        m_queue.push(job(std::forward<F>(operation)));
-        retv = m_queue.back().promise.get_future();
+        return reject();
     }
-    m_available.notify_one();
+    job j(std::forward<F>(operation));
+    std::future<R> retv = j.promise.emplace(std::allocator_arg, _impl::PoolAllocator<char>(m_promises)).get_future();
+    enqueue(std::move(j), priority);
+    return retv;
+}
+
+template <class R>
+template <class F>
+void ReduCxx::ActiveObject<R>::postDetached(F&& operation, Priority priority)
+{
+    if (admit(true))
+    {
+        enqueue(job(std::forward<F>(operation)), priority);
+    }
+}
+
+template <class R>
+template <class F>
+std::optional<std::future<R>> ReduCxx::ActiveObject<R>::tryPost(F&& operation, Priority priority)
+{
+    if (!admit(false))
+    {
+        return std::nullopt;
+    }
+    job j(std::forward<F>(operation));
+    std::future<R> retv = j.promise.emplace(std::allocator_arg, _impl::PoolAllocator<char>(m_promises)).get_future();
+    enqueue(std::move(j), priority);
+    return retv;
+}
+
+template <class R>
+template <class F>
+bool ReduCxx::ActiveObject<R>::tryPostDetached(F&& operation, Priority priority)
+{
+    if (!admit(false))
+    {
+        return false;
+    }
+    enqueue(job(std::forward<F>(operation)), priority);
+    return true;
+}
+
+template <class R>
+template <class F>
+std::future<R> ReduCxx::ActiveObject<R>::postUnbounded(F&& operation, Priority priority)
+{
+    job j(std::forward<F>(operation));
+    j.bounded = false;
+    std::future<R> retv = j.promise.emplace(std::allocator_arg, _impl::PoolAllocator<char>(m_promises)).get_future();
+    enqueue(std::move(j), priority);
     return retv;
 }
 
+template <class R>
+void ReduCxx::ActiveObject<R>::setErrorSink(error_sink sink)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_error_sink = std::move(sink);
+}
+
+template <class R>
+void ReduCxx::ActiveObject<R>::executeDetached(job& j)
+{
+    try
+    {
+        j.operation();
+    }
+    catch (...)
+    {
+        error_sink sink;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            sink = m_error_sink;
+        }
+        if (sink)
+        {
+            sink(std::current_exception());
+        }
+    }
+}
+
+/**
+ * Make room for a new bounded job as told by the queue policy, waiting for it
+ * only if @a wait; return false if the job is rejected.
+ * The worker never waits for itself: its own posts overflow the capacity.
+ */
+template <class R>
+bool ReduCxx::ActiveObject<R>::admit(bool wait)
+{
+    if (!m_queue.isBounded() || reserve())
+    {
+        return true;
+    }
+    if (wait)
+    {
+        switch (m_queue.overflow())
+        {
+        case QueuePolicy::Overflow::BLOCK:
+            if (isWorker())
+            {
+                m_size.fetch_add(1);
+                return true;
+            }
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_blocked.fetch_add(1);
+                m_room.wait(lock, [&]() { return m_quit.load() || reserve(); });
+                m_blocked.fetch_sub(1, std::memory_order_relaxed);
+            }
+            return true;
+        case QueuePolicy::Overflow::FAIL:
+            m_rejected.fetch_add(1, std::memory_order_relaxed);
+            throw QueueFullError();
+        case QueuePolicy::Overflow::DROP_OLDEST:
+            // the worker drops the oldest jobs before running the next one; while it
+            // is busy with a job, up to capacity more are queued before dropping new ones
+            if (m_overdue.fetch_add(1) < m_queue.capacity())
+            {
+                m_size.fetch_add(1);
+                return true;
+            }
+            m_overdue.fetch_sub(1);
+            break;
+        case QueuePolicy::Overflow::DROP_NEWEST:
+            break;
+        }
+    }
+    m_rejected.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+//! Count a new job in if the queue is not full
+template <class R>
+bool ReduCxx::ActiveObject<R>::reserve()
+{
+    // seq_cst against release(): a blocked producer either sees the room or is seen blocked
+    std::size_t size = m_size.load();
+    while (size < m_queue.capacity())
+    {
+        if (m_size.compare_exchange_weak(size, size + 1))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//! Count a bounded job out, on the worker
+template <class R>
+void ReduCxx::ActiveObject<R>::release()
+{
+    m_size.fetch_sub(1);
+    // seq_cst against a producer blocking: either it sees the room or we see it blocked
+    if (m_blocked.load() > 0)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+        }
+        m_room.notify_one();
+    }
+}
+
+//! Future of a job dropped as soon as posted
+template <class R>
+std::future<R> ReduCxx::ActiveObject<R>::reject()
+{
+    std::promise<R> promise(std::allocator_arg, _impl::PoolAllocator<char>(m_promises));
+    promise.set_exception(std::make_exception_ptr(QueueFullError()));
+    return promise.get_future();
+}
+
+template <class R>
+void ReduCxx::ActiveObject<R>::enqueue(job&& j, Priority priority)
+{
+#if REDUCXX_METRICS
+    j.posted = std::chrono::steady_clock::now();
+    const std::size_t depth = m_depth.fetch_add(1, std::memory_order_relaxed) + 1;
+    std::size_t high = m_high_water.load(std::memory_order_relaxed);
+    while (depth > high && !m_high_water.compare_exchange_weak(high, depth, std::memory_order_relaxed)) { }
+#endif
+    m_lanes[static_cast<std::size_t>(priority)].push(std::move(j));
+    // seq_cst against the worker parking: either it sees the job or we see it parked
+    if (m_parked.load())
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+        }
+        m_available.notify_one();
+    }
+}
+
+/**
+ * Drop the oldest jobs of the lowest priority lanes, as long as there are
+ * overdue ones, then pick the next job; an unbounded job met on the way is
+ * picked instead of dropped, being the oldest of its lane.
+ */
+template <class R>
+std::optional<typename ReduCxx::ActiveObject<R>::job> ReduCxx::ActiveObject<R>::shed()
+{
+    auto lowest = [this]() -> std::optional<job> {
+        for (auto lane = m_lanes.rbegin(); lane != m_lanes.rend(); ++lane)
+        {
+            if (std::optional<job> j = lane->pop())
+            {
+                return j;
+            }
+        }
+        return std::nullopt;
+    };
+    while (m_overdue.load(std::memory_order_relaxed) > 0)
+    {
+        std::optional<job> j = lowest();
+        if (!j || !j->bounded)
+        {
+            return j;   // none when the overdue jobs are half-way through their push
+        }
+        m_overdue.fetch_sub(1, std::memory_order_relaxed);
+        m_rejected.fetch_add(1, std::memory_order_relaxed);
+        dequeued(*j);
+        release();
+        if (j->promise)
+        {
+            j->promise->set_exception(std::make_exception_ptr(QueueFullError()));
+        }
+    }
+    return take();
+}
+
+/**
+ * Pick the next job: from the highest priority lane in strict mode, otherwise
+ * from the first lane with both jobs and credits left, refilling the credits
+ * once no such lane is left.
+ */
+template <class R>
+std::optional<typename ReduCxx::ActiveObject<R>::job> ReduCxx::ActiveObject<R>::take()
+{
+    if (m_policy.isStrict())
+    {
+        for (_impl::MpscQueue<job>& lane : m_lanes)
+        {
+            if (std::optional<job> j = lane.pop())
+            {
+                return j;
+            }
+        }
+        return std::nullopt;
+    }
+    for (int round = 0; round < 2; ++round)
+    {
+        for (std::size_t i = 0; i < LanePolicy::LANES; ++i)
+        {
+            if (m_credits[i] == 0)
+            {
+                continue;
+            }
+            if (std::optional<job> j = m_lanes[i].pop())
+            {
+                --m_credits[i];
+                return j;
+            }
+        }
+        for (std::size_t i = 0; i < LanePolicy::LANES; ++i)
+        {
+            m_credits[i] = m_policy.weight(static_cast<Priority>(i));
+        }
+    }
+    return std::nullopt;
+}
+
+//! Account for @a j leaving the queue, on the worker
+template <class R>
+void ReduCxx::ActiveObject<R>::dequeued(const job& j)
+{
+#if REDUCXX_METRICS
+    m_depth.fetch_sub(1, std::memory_order_relaxed);
+    m_posted = j.posted;
+#else
+    (void)j;
+#endif
+}
+
+template <class R>
+bool ReduCxx::ActiveObject<R>::empty() const
+{
+    for (const _impl::MpscQueue<job>& lane : m_lanes)
+    {
+        if (!lane.empty())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 template <class R>
 void ReduCxx::ActiveObject<R>::run()
 {
     for (;;)
     {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        while (m_queue.empty() || m_quit)
+        if (m_quit.load(std::memory_order_acquire))
         {
-            if (m_quit)
+            return;
+        }
+        std::optional<job> j = m_overdue.load(std::memory_order_relaxed) > 0 ? shed() : take();
+        if (j)
+        {
+            dequeued(*j);
+        }
+        if (j && j->bounded && m_queue.isBounded())
+        {
+            release();
+        }
+        if (!j)
+        {
+            if (!empty())
             {
-                return;
+                std::this_thread::yield();  // a producer is half-way through a push
+                continue;
             }
-            m_available.wait(lock);
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_parked.store(true);
+            m_available.wait(lock, [&]() { return m_quit.load() || !empty(); });
+            m_parked.store(false, std::memory_order_relaxed);
+            continue;
         }
-        job j = std::move(m_queue.front());
-        m_queue.pop();
-        lock.unlock();
         try
         {
-            execute<R>(j);
+            if (j->promise)
+            {
+                execute<R>(*j);
+            }
+            else
+            {
+                executeDetached(*j);
+            }
         }
         catch (...)
         {
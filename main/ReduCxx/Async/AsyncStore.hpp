@@ -3,12 +3,23 @@
 
 #include "ReduCxx/Store.hpp"
 #include "ActiveObject.hpp"
+#include "DispatchPolicy.hpp"
+#include "Metrics.hpp"
+#include "Seqlock.hpp"
+#include "StateReader.hpp"
 #include "SubscriptionHandle.hpp"
+#include "ThreadPool.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
 #include <thread>
+#include <variant>
+#include <vector>
 
 namespace ReduCxx {
-    template <class S, class A>
+    template <class S, class A, class R = _impl::ErasedReducer<S, A>>
     class AsyncStore;
 }
 
@@ -18,21 +29,39 @@ namespace ReduCxx {
  * dispatch state changes from different threads.
  * 
  * Please be aware that reducers shall not access to shared resources.
+ *
+ * Each new state is published as an immutable snapshot before subscriptions
+ * run: reading the state never waits for reducers nor subscriptions.
+ * Small trivially copyable states (or sub-states of a std::tuple state) are
+ * also published through a seqlock, so that @a state() copies them without
+ * taking any lock.
+ *
+ * With REDUCXX_METRICS the latencies of the dispatches are recorded, see
+ * @a metrics.
  */
-template <class S, class A>
+template <class S, class A, class R>
 class ReduCxx::AsyncStore {
 public:
 
+    /**
+     * @brief Build an AsyncStore around given @a reducer.
+     * @param history states retained by the underlying Store; since an
+     * AsyncStore cannot revert, only the current state is kept by default.
+     * @param dispatch whether queued actions are reduced one by one or
+     * coalesced and how their priority lanes are served, see
+     * @a DispatchPolicy.
+     */
     template <class F>
-    explicit AsyncStore(const F& reducer)
-        : m_store(reducer)
-    { }
-
-    AsyncStore(AsyncStore&& temp) noexcept
-        : m_store(std::move(temp.m_store))
-        , m_reducer_thread(std::move(temp.m_reducer_thread))
+    explicit AsyncStore(const F& reducer, const HistoryPolicy& history = HistoryPolicy::bounded(1),
+                        const DispatchPolicy& dispatch = DispatchPolicy::sequential())
+        : m_store(reducer, history)
+        , m_coalesced(dispatch.isCoalesced())
+        , m_snapshot(makeSnapshot())
+        , m_seqlocks(m_store.state())
+        , m_reducer_thread(dispatch.lanes(), dispatch.isCoalesced() ? QueuePolicy::unbounded() : dispatch.queue())
     { }
 
+    // the reducers thread runs on this very object: it can be neither copied nor moved
     AsyncStore(const AsyncStore&) = delete;
     AsyncStore& operator =(const AsyncStore&) = delete;
 
@@ -42,10 +71,86 @@ public:
      * 
      * The returned future can be ignored but, in case of exception, it will 
      * pass undetected: If a reducer throws, the exception is bounded to the 
-     * future an rethrown on future.get(), state is left unchanged.
+     * future an rethrown on future.get(), state is left unchanged (unless
+     * reducers consume the state, see @a Store::Store).
+     *
+     * Actions are reduced in order within a @a priority lane, the lanes being
+     * served as told by the DispatchPolicy: a HIGH action overtakes the
+     * NORMAL and LOW ones still queued. In coalesced mode only NORMAL actions
+     * are coalesced, the other ones are reduced one by one.
+     *
+     * When the DispatchPolicy bounds the queue and it is full, this waits for
+     * room, throws a QueueFullError or drops a dispatch, whose future then
+     * holds a QueueFullError, see @a ActiveObject::post.
+     */
+    std::future<void> dispatch(const A& action, Priority priority = Priority::NORMAL);
+    std::future<void> dispatch(A&& action, Priority priority = Priority::NORMAL);
+
+    /**
+     * @brief Same as @a dispatch, but rejecting @a action if the queue is
+     * full whatever the policy, see @a ActiveObject::tryPost.
+     * @return the future of the dispatch, none if rejected
+     */
+    std::optional<std::future<void>> tryDispatch(const A& action, Priority priority = Priority::NORMAL);
+
+    //! @brief Number of dispatches rejected or dropped so far because the queue was full
+    std::uint64_t rejected() const {
+        return m_reducer_thread.rejected();
+    }
+
+    /**
+     * @brief Same as @a dispatch but without a future to complete, sparing
+     * the allocation of its shared state: exceptions of reducers and
+     * subscriptions are passed to the error sink instead (see
+     * @a setErrorSink).
+     */
+    void dispatchDetached(const A& action, Priority priority = Priority::NORMAL);
+    void dispatchDetached(A&& action, Priority priority = Priority::NORMAL);
+
+    /**
+     * @brief Return the latencies of the dispatches completed so far and the
+     * depth of the queue of the reducers thread, without stopping it: the
+     * dispatches completing meanwhile may be partially accounted for.
+     * Everything is empty unless REDUCXX_METRICS is set.
+     */
+    DispatchMetrics metrics() const {
+#if REDUCXX_METRICS
+        return m_metrics->snapshot(m_reducer_thread.metrics());
+#else
+        return {};
+#endif
+    }
+
+    /**
+     * @brief Set the function receiving the exceptions of detached
+     * dispatches; it runs on the reducers thread and shall not throw.
+     * Without a sink those exceptions are discarded.
+     */
+    void setErrorSink(const typename ActiveObject<void>::error_sink& sink);
+
+    /**
+     * @brief Run @a op on the reducers thread, once the actions dispatched so
+     * far are reduced and before the ones dispatched afterwards, as long as
+     * they are all dispatched with the NORMAL priority.
+     * @a op is never rejected by a full queue; it shall not wait for this Store.
      */
-    std::future<void> dispatch(const A& action);
-    std::future<void> dispatch(A&& action);
+    template <class F>
+    std::future<void> post(F&& op) {
+        return m_reducer_thread.postUnbounded(std::forward<F>(op));
+    }
+
+    /**
+     * @brief Process the actions in [@a first, @a last) as a single batch on
+     * the reducers thread, see @a Store::dispatchBatch.
+     * The actions are copied; the returned future completes once the whole
+     * batch is reduced and subscriptions are run.
+     */
+    template <class It>
+    std::future<void> dispatchBatch(It first, It last, Priority priority = Priority::NORMAL) {
+        return dispatchBatch(std::vector<A>(first, last), priority);
+    }
+
+    std::future<void> dispatchBatch(std::vector<A>&& actions, Priority priority = Priority::NORMAL);
 
     //! @brief Return a copy of current state
     S state() const;
@@ -58,6 +163,30 @@ public:
     template <class T>
     T state();
 
+    /**
+     * @brief Return a handle to the current state, which stays valid and
+     * unchanged as long as it is held, without copying it.
+     */
+    std::shared_ptr<const S> snapshot() const {
+        return m_snapshot.current();
+    }
+
+    /**
+     * @brief Return a reader for the calling thread, for frequent reads: it
+     * only synchronizes with the reducers thread when a new state has been
+     * published since its last read, see @a StateReader.
+     */
+    StateReader<S> reader() const {
+        return StateReader<S>(m_snapshot);
+    }
+
+    //! @brief Return the version of the sub-state of index @a I, see @a Store::version
+    template <size_t I = 0>
+    std::uint64_t version() const {
+        StateLock lock(*this);
+        return m_store.template version<I>();
+    }
+
     /**
      * @brief Add given function or function to the Store subscriptions for state change.
      * Subscriptions will run on the reducers thread and are then synchronous 
@@ -67,82 +196,551 @@ public:
      * computations here, otherwise the event processing may slow down excessively.
      * Long computations could be moved to another thread with any custom signalling mechanism or you can use
      * a @a ReduCxx::ActiveObject and the @a AsyncStore::subscribeAsync function directly.
+     * Subscribing is safe while actions are dispatched, from any thread or
+     * subscription; see @a Store::subscribe for when the callback starts.
+     * @return the token to @a unsubscribe the callback
      */ 
     template <class F>
-    void subscribeSync(const F& callback) {
-        m_store.subscribe(callback); 
+    Subscription subscribeSync(const F& callback) {
+        return locked([&]() { return m_store.subscribe(callback); });
+    }
+
+    /**
+     * @brief Add given @a callback to the subscriptions for changes of the
+     * slice of the state projected by @a selector, see @a Store::subscribe.
+     * The callback receives the new slice, so it has no need to read the
+     * state back through @a state().
+     */
+    template <class Selector, class F, class Equal = std::equal_to<>>
+    Subscription subscribeSync(const Selector& selector, const F& callback, const Equal& equal = Equal()) {
+        return locked([&]() { return m_store.subscribe(selector, callback, equal); });
     }
 
+    /**
+     * @brief Remove the synchronous subscription of given @a token, see
+     * @a Store::unsubscribe; once it returns, the callback is not called
+     * anymore. It can be called by the subscriptions themselves.
+     * Asynchronous subscriptions are removed once their handle is released.
+     * @return false if already removed
+     */
+    bool unsubscribe(const Subscription& token);
+
     /**
      * @brief Add given function to the Store subscriptions for state changes.
      * Subscriptions will run on the given <i>active object</i>.
      * @return a reference to a heap allocated handle that collect results from each execution
-     * of the subscriber, if you are not interested in them, discard or dispose the returned pointer
-     * to avoid memory overload.
+     * of the subscriber, if you are not interested in them, use a counting @a tracking policy to
+     * avoid memory overload. The subscription lasts as long as the handle: once it is released,
+     * the next state change removes the subscription instead of posting to @a subscriber.
      */
     template <class F>
-    std::shared_ptr<SubscriptionHandle> subscribeAsync(ActiveObject<void>& subscriber, const F& op);
+    std::shared_ptr<SubscriptionHandle> subscribeAsync(ActiveObject<void>& subscriber, const F& op) {
+        return subscribeAsync(subscriber, TrackingPolicy::futures(), op);
+    }
+
+    template <class F>
+    std::shared_ptr<SubscriptionHandle> subscribeAsync(ActiveObject<void>& subscriber, const TrackingPolicy& tracking,
+                                                       const F& op);
+
+    /**
+     * @brief Add given function to the subscriptions for changes of the slice
+     * of the state projected by @a selector, see @a Store::subscribe.
+     * @a op runs on the given <i>active object</i> and receives a copy of the
+     * new slice; nothing is posted while the slice does not change.
+     */
+    template <class Selector, class F, class Equal = std::equal_to<>>
+    std::shared_ptr<SubscriptionHandle> subscribeAsync(ActiveObject<void>& subscriber, const Selector& selector,
+                                                       const F& op, const Equal& equal = Equal()) {
+        return subscribeAsync(subscriber, TrackingPolicy::futures(), selector, op, equal);
+    }
+
+    template <class Selector, class F, class Equal = std::equal_to<>>
+    std::shared_ptr<SubscriptionHandle> subscribeAsync(ActiveObject<void>& subscriber, const TrackingPolicy& tracking,
+                                                       const Selector& selector, const F& op,
+                                                       const Equal& equal = Equal());
+
+    /**
+     * @brief Same as @a subscribeAsync on an active object, but running @a op
+     * on a shared thread pool: each subscription gets its own @a Strand, so
+     * its executions never overlap and follow the state changes order, while
+     * different subscriptions run in parallel.
+     * @warning @a pool shall outlive the Store.
+     */
+    template <class F>
+    std::shared_ptr<SubscriptionHandle> subscribeAsync(ThreadPool& pool, const F& op) {
+        return subscribeAsync(pool, TrackingPolicy::futures(), op);
+    }
+
+    template <class F>
+    std::shared_ptr<SubscriptionHandle> subscribeAsync(ThreadPool& pool, const TrackingPolicy& tracking, const F& op);
+
+    template <class Selector, class F, class Equal = std::equal_to<>>
+    std::shared_ptr<SubscriptionHandle> subscribeAsync(ThreadPool& pool, const Selector& selector,
+                                                       const F& op, const Equal& equal = Equal()) {
+        return subscribeAsync(pool, TrackingPolicy::futures(), selector, op, equal);
+    }
+
+    template <class Selector, class F, class Equal = std::equal_to<>>
+    std::shared_ptr<SubscriptionHandle> subscribeAsync(ThreadPool& pool, const TrackingPolicy& tracking,
+                                                       const Selector& selector, const F& op,
+                                                       const Equal& equal = Equal());
 
 private:
-    Store<S, A> m_store;
+    //! A dispatch waiting for the reducers thread in coalesced mode
+    struct Pending {
+        explicit Pending(std::variant<A, std::vector<A>>&& actions) : actions(std::move(actions)) { }
+
+        std::variant<A, std::vector<A>> actions;
+        std::optional<std::promise<void>> promise;  // none for detached dispatches
+        bool failed = false;
+#if REDUCXX_METRICS
+        std::chrono::steady_clock::time_point posted = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::duration reduce {};
+#endif
+    };
+
+    Store<S, A, R> m_store;
     mutable std::mutex m_mutex;
+    mutable std::atomic<std::thread::id> m_holder {};  // thread holding m_mutex, if any
+    const bool m_coalesced;
+    std::shared_ptr<_impl::BlockPool> m_blocks = std::make_shared<_impl::BlockPool>(); // promises and snapshots
+    _impl::SnapshotCell<S> m_snapshot;
+    _impl::SeqlockSlices<S> m_seqlocks;
+    std::mutex m_pending_mutex;
+    std::vector<Pending> m_pending;
+    std::vector<Pending> m_collected;   // swapped with m_pending by the drain job, to keep both capacities
+    bool m_draining = false;    // a drain job is queued and has not collected m_pending yet
+    typename ActiveObject<void>::error_sink m_error_sink;   // guarded by m_pending_mutex
+#if REDUCXX_METRICS
+    std::unique_ptr<_impl::DispatchRecorder> m_metrics = std::make_unique<_impl::DispatchRecorder>();
+#endif
     ActiveObject<void> m_reducer_thread;
 
-    void doDispatch(const A& action);
+    //! Lock of m_mutex telling which thread holds it, see @a locked
+    class StateLock {
+    public:
+        explicit StateLock(const AsyncStore& store) : m_store(store), m_lock(store.m_mutex) {
+            m_store.m_holder.store(std::this_thread::get_id(), std::memory_order_relaxed);
+        }
+
+        ~StateLock() {
+            m_store.m_holder.store(std::thread::id(), std::memory_order_relaxed);
+        }
+
+        StateLock(const StateLock&) = delete;
+        StateLock& operator =(const StateLock&) = delete;
+
+    private:
+        const AsyncStore& m_store;
+        std::unique_lock<std::mutex> m_lock;
+    };
+
+    /**
+     * Run @a op on the Store under m_mutex, unless the calling thread already
+     * holds it: subscriptions, run under the lock, may call back this Store.
+     */
+    template <class F>
+    decltype(auto) locked(const F& op) {
+        // only this thread stores its own id, so a relaxed load tells whether it holds the lock
+        if (m_holder.load(std::memory_order_relaxed) == std::this_thread::get_id()) {
+            return op();
+        }
+        StateLock lock(*this);
+        return op();
+    }
+
+    std::shared_ptr<const S> makeSnapshot() const {
+        return std::allocate_shared<S>(_impl::PoolAllocator<S>(m_blocks), m_store.state());
+    }
+
+    //! Publish the new state, on the reducers thread
+    void publish() {
+        m_seqlocks.publish(m_store.state(), m_store.dirty());
+        m_snapshot.publish(makeSnapshot());
+    }
+
+    void doDispatch(const A& action) {
+        reduce([&]() { m_store.dispatch(action); });
+    }
+
+    void doDispatchBatch(const std::vector<A>& actions) {
+        reduce([&]() { m_store.dispatchBatch(actions.begin(), actions.end()); });
+    }
+
+    //! Run @a op dispatching to the Store, then publish and notify, on the reducers thread
+    template <class F>
+    void reduce(const F& op);
+
+    /**
+     * Post @a op to @a subscriber, its result being collected by @a handle if
+     * still alive; the result is added (or counted as expected) before @a op
+     * can run, so that it is already counted once @a op starts. A run dropped
+     * or rejected by a full subscriber queue completes with a QueueFullError.
+     */
+    template <class Executor, class F>
+    static void postTracked(Executor& subscriber, const std::weak_ptr<SubscriptionHandle>& handle, F&& op);
+
+    void enqueue(Pending&& pending);
+    void drain();
+
+    //! Counting mode: an execution expected by a handle, completed once run
+    //! or, if destroyed before, with a QueueFullError
+    class Expected {
+    public:
+        explicit Expected(const std::weak_ptr<SubscriptionHandle>& handle) : m_handle(handle) { }
+
+        Expected(Expected&& temp) noexcept : m_handle(std::move(temp.m_handle)) { temp.m_handle.reset(); }
+
+        Expected& operator =(Expected&&) = delete;
+
+        ~Expected() {
+            if (!m_handle.expired()) {
+                done(std::make_exception_ptr(QueueFullError()));
+            }
+        }
+
+        void done(std::exception_ptr error) {
+            if (auto handle = m_handle.lock()) {
+                handle->done(std::move(error));
+            }
+            m_handle.reset();
+        }
+
+    private:
+        std::weak_ptr<SubscriptionHandle> m_handle;
+    };
 };
 
-template <class S, class A>
-std::future<void> ReduCxx::AsyncStore<S, A>::dispatch(const A& action) {
+template <class S, class A, class R>
+std::future<void> ReduCxx::AsyncStore<S, A, R>::dispatch(const A& action, Priority priority) {
+    if (m_coalesced && priority == Priority::NORMAL) {
+        Pending pending(std::variant<A, std::vector<A>>(std::in_place_index<0>, action));
+        std::future<void> result = pending.promise.emplace(std::allocator_arg, _impl::PoolAllocator<char>(m_blocks)).get_future();
+        enqueue(std::move(pending));
+        return result;
+    }
+    return m_reducer_thread.post(
+        [this, action]() { doDispatch(action); }, priority);
+}
+
+template <class S, class A, class R>
+std::future<void> ReduCxx::AsyncStore<S, A, R>::dispatch(A&& action, Priority priority) {
+    if (m_coalesced && priority == Priority::NORMAL) {
+        Pending pending(std::variant<A, std::vector<A>>(std::in_place_index<0>, std::move(action)));
+        std::future<void> result = pending.promise.emplace(std::allocator_arg, _impl::PoolAllocator<char>(m_blocks)).get_future();
+        enqueue(std::move(pending));
+        return result;
+    }
     return m_reducer_thread.post(
-        std::bind(&AsyncStore<S, A>::doDispatch, this, action));
+        [this, action = std::move(action)]() { doDispatch(action); }, priority);
+}
+
+template <class S, class A, class R>
+bool ReduCxx::AsyncStore<S, A, R>::unsubscribe(const Subscription& token) {
+    return locked([&]() { return m_store.unsubscribe(token); });
+}
+
+template <class S, class A, class R>
+std::optional<std::future<void>> ReduCxx::AsyncStore<S, A, R>::tryDispatch(const A& action, Priority priority) {
+    if (m_coalesced && priority == Priority::NORMAL) {
+        return dispatch(action);
+    }
+    return m_reducer_thread.tryPost(
+        [this, action]() { doDispatch(action); }, priority);
 }
 
-template <class S, class A>
-std::future<void> ReduCxx::AsyncStore<S, A>::dispatch(A&& action) {
+template <class S, class A, class R>
+void ReduCxx::AsyncStore<S, A, R>::dispatchDetached(const A& action, Priority priority) {
+    if (m_coalesced && priority == Priority::NORMAL) {
+        enqueue(Pending(std::variant<A, std::vector<A>>(std::in_place_index<0>, action)));
+        return;
+    }
+    m_reducer_thread.postDetached(
+        [this, action]() { doDispatch(action); }, priority);
+}
+
+template <class S, class A, class R>
+void ReduCxx::AsyncStore<S, A, R>::dispatchDetached(A&& action, Priority priority) {
+    if (m_coalesced && priority == Priority::NORMAL) {
+        enqueue(Pending(std::variant<A, std::vector<A>>(std::in_place_index<0>, std::move(action))));
+        return;
+    }
+    m_reducer_thread.postDetached(
+        [this, action = std::move(action)]() { doDispatch(action); }, priority);
+}
+
+template <class S, class A, class R>
+void ReduCxx::AsyncStore<S, A, R>::setErrorSink(const typename ActiveObject<void>::error_sink& sink) {
+    {
+        std::unique_lock<std::mutex> lock(m_pending_mutex);
+        m_error_sink = sink;
+    }
+    m_reducer_thread.setErrorSink(sink);
+}
+
+template <class S, class A, class R>
+std::future<void> ReduCxx::AsyncStore<S, A, R>::dispatchBatch(std::vector<A>&& actions, Priority priority) {
+    if (m_coalesced && priority == Priority::NORMAL) {
+        Pending pending(std::variant<A, std::vector<A>>(std::in_place_index<1>, std::move(actions)));
+        std::future<void> result = pending.promise.emplace(std::allocator_arg, _impl::PoolAllocator<char>(m_blocks)).get_future();
+        enqueue(std::move(pending));
+        return result;
+    }
     return m_reducer_thread.post(
-        std::bind(&AsyncStore<S, A>::doDispatch, this, std::move(action)));
+        [this, actions = std::move(actions)]() { doDispatchBatch(actions); }, priority);
+}
+
+template <class S, class A, class R>
+void ReduCxx::AsyncStore<S, A, R>::enqueue(Pending&& pending) {
+    std::unique_lock<std::mutex> lock(m_pending_mutex);
+    m_pending.push_back(std::move(pending));
+    if (!m_draining) {
+        // posted under the lock, so that drain jobs are queued in order
+        m_draining = true;
+        m_reducer_thread.postDetached([this]() { drain(); });
+    }
+}
+
+/**
+ * Reduce all the pending actions under a single lock of the state, running
+ * subscriptions once; errors of each dispatch go to its own future (or to the
+ * error sink), errors of the subscriptions to the futures of all the
+ * dispatches that succeeded (and once to the error sink).
+ */
+template <class S, class A, class R>
+void ReduCxx::AsyncStore<S, A, R>::drain() {
+    std::vector<Pending>& batch = m_collected;    // only touched by the reducer thread
+    typename ActiveObject<void>::error_sink sink;
+    {
+        std::unique_lock<std::mutex> lock(m_pending_mutex);
+        batch.swap(m_pending);
+        m_draining = false;
+        sink = m_error_sink;
+    }
+#if REDUCXX_METRICS
+    using clock = std::chrono::steady_clock;
+    const clock::time_point started = clock::now();
+    clock::time_point notifying;
+#endif
+    auto fail = [&sink](Pending& pending, const std::exception_ptr& error) {
+        if (pending.promise) {
+            pending.promise->set_exception(error);
+        } else if (sink) {
+            sink(error);
+        }
+    };
+
+    std::exception_ptr error;
+    {
+        StateLock lock(*this);
+        try {
+            m_store.deferNotifications([&]() {
+                bool dispatched = false;
+                for (Pending& pending : batch) {
+                    try {
+#if REDUCXX_METRICS
+                        const clock::time_point reducing = clock::now();
+#endif
+                        if (pending.actions.index() == 0) {
+                            m_store.dispatch(std::get<0>(pending.actions));
+                        } else {
+                            const std::vector<A>& actions = std::get<1>(pending.actions);
+                            m_store.dispatchBatch(actions.begin(), actions.end());
+                        }
+#if REDUCXX_METRICS
+                        pending.reduce = clock::now() - reducing;
+#endif
+                        dispatched = true;
+                    } catch (...) {
+                        pending.failed = true;
+                        fail(pending, std::current_exception());
+                    }
+                }
+                if (dispatched && m_store.dirty() != 0) {
+                    publish();
+                }
+#if REDUCXX_METRICS
+                notifying = clock::now();
+#endif
+            });
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+
+#if REDUCXX_METRICS
+    const clock::time_point done = clock::now();
+#endif
+    bool detached = false;
+    for (Pending& pending : batch) {
+        if (pending.failed) {
+            continue;
+        }
+#if REDUCXX_METRICS
+        if (!error) {
+            m_metrics->record(pending.posted, started, pending.reduce, done - notifying, done);
+        }
+#endif
+        if (!pending.promise) {
+            detached = true;
+        } else if (error) {
+            pending.promise->set_exception(error);
+        } else {
+            pending.promise->set_value();
+        }
+    }
+    batch.clear();  // keep the capacity for the next swap
+    if (error && detached && sink) {
+        sink(error);
+    }
 }
 
-template<class S, class A>
-S ReduCxx::AsyncStore<S, A>::state() const {
-    std::unique_lock<std::mutex> lock(m_mutex);
-    return m_store.state();
+template <class S, class A, class R>
+S ReduCxx::AsyncStore<S, A, R>::state() const {
+    if constexpr (_impl::SeqlockSlices<S>::WHOLE) {
+        return m_seqlocks.load();
+    }
+    return *m_snapshot.current();
 }
 
-template<class S, class A>
+template <class S, class A, class R>
 template <size_t I>
-std::tuple_element_t<I, S> ReduCxx::AsyncStore<S, A>::state()
+std::tuple_element_t<I, S> ReduCxx::AsyncStore<S, A, R>::state()
 {
-    std::unique_lock<std::mutex> lock(m_mutex);
-    return std::get<I>(m_store.state());
+    if constexpr (_impl::SeqlockSlices<S>::template SLICE<I>) {
+        return m_seqlocks.template load<I>();
+    }
+    return std::get<I>(*m_snapshot.current());
 }
 
-template<class S, class A>
+template <class S, class A, class R>
 template<class T>
-T ReduCxx::AsyncStore<S, A>::state()
+T ReduCxx::AsyncStore<S, A, R>::state()
 {
-    std::unique_lock<std::mutex> lock(m_mutex);
-    return std::get<T>(m_store.state());
+    if constexpr (_impl::SeqlockSlices<S>::template SLICE_OF<T>) {
+        return m_seqlocks.template load<T>();
+    }
+    return std::get<T>(*m_snapshot.current());
 }
 
-template <class S, class A>
-void ReduCxx::AsyncStore<S, A>::doDispatch(const A& action)
+template <class S, class A, class R>
+template <class F>
+void ReduCxx::AsyncStore<S, A, R>::reduce(const F& op)
 {
-    std::unique_lock<std::mutex> lock(m_mutex);
-    m_store.dispatch(action);
+#if REDUCXX_METRICS
+    using clock = std::chrono::steady_clock;
+    const clock::time_point started = clock::now();
+    clock::time_point notifying;
+#endif
+    StateLock lock(*this);
+    m_store.deferNotifications([&]() {
+        op();
+        if (m_store.dirty() != 0) {
+            publish();
+        }
+#if REDUCXX_METRICS
+        notifying = clock::now();
+#endif
+    });
+#if REDUCXX_METRICS
+    const clock::time_point done = clock::now();
+    m_metrics->record(m_reducer_thread.postedAt(), started, notifying - started, done - notifying, done);
+#endif
+}
+
+template <class S, class A, class R>
+template <class Executor, class F>
+void ReduCxx::AsyncStore<S, A, R>::postTracked(Executor& subscriber,
+                                               const std::weak_ptr<SubscriptionHandle>& handle, F&& op) {
+    auto caller_handle = handle.lock();
+    if (caller_handle && caller_handle->isCounting()) {
+        caller_handle->expect();
+        subscriber.postDetached([op = std::forward<F>(op), expected = Expected(handle)]() mutable {
+            std::exception_ptr error;
+            try {
+                op();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            expected.done(std::move(error));
+        });
+        return;
+    }
+    std::promise<void> promise;
+    if (caller_handle) {
+        caller_handle->add(promise.get_future());
+    }
+    subscriber.postDetached([op = std::forward<F>(op), promise = std::move(promise)]() mutable {
+        try {
+            op();
+            promise.set_value();
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+    });
 }
 
-template<class S, class A>
+template <class S, class A, class R>
 template<class F>
 std::shared_ptr<ReduCxx::SubscriptionHandle>
-ReduCxx::AsyncStore<S, A>::subscribeAsync(ReduCxx::ActiveObject<void> &subscriber, const F &op) {
-    std::shared_ptr<SubscriptionHandle> caller_handle(new SubscriptionHandle);
+ReduCxx::AsyncStore<S, A, R>::subscribeAsync(ReduCxx::ActiveObject<void> &subscriber, const TrackingPolicy& tracking,
+                                             const F &op) {
+    std::shared_ptr<SubscriptionHandle> caller_handle(new SubscriptionHandle(tracking));
     std::weak_ptr<SubscriptionHandle> handler_handle = caller_handle;
-    m_store.subscribe([&subscriber, op, handler_handle]() {
-        std::future<void> result = subscriber.post(op);
-        if (auto handle = handler_handle.lock()) {
-            handle->add(std::move(result));
-        }
+    locked([&]() {
+        const Subscription token = m_store.subscribe([&subscriber, op, handler_handle]() {
+            postTracked(subscriber, handler_handle, op);
+        });
+        m_store.tie(token, caller_handle);
+    });
+    return caller_handle;
+}
+
+template <class S, class A, class R>
+template <class Selector, class F, class Equal>
+std::shared_ptr<ReduCxx::SubscriptionHandle>
+ReduCxx::AsyncStore<S, A, R>::subscribeAsync(ReduCxx::ActiveObject<void> &subscriber, const TrackingPolicy& tracking,
+                                             const Selector& selector, const F &op, const Equal& equal) {
+    std::shared_ptr<SubscriptionHandle> caller_handle(new SubscriptionHandle(tracking));
+    std::weak_ptr<SubscriptionHandle> handler_handle = caller_handle;
+    locked([&]() {
+        const Subscription token = m_store.subscribe(selector, [&subscriber, op, handler_handle](const auto& slice) {
+            postTracked(subscriber, handler_handle, [op, slice]() mutable { op(slice); });
+        }, equal);
+        m_store.tie(token, caller_handle);
+    });
+    return caller_handle;
+}
+
+template <class S, class A, class R>
+template<class F>
+std::shared_ptr<ReduCxx::SubscriptionHandle>
+ReduCxx::AsyncStore<S, A, R>::subscribeAsync(ReduCxx::ThreadPool& pool, const TrackingPolicy& tracking, const F& op) {
+    std::shared_ptr<SubscriptionHandle> caller_handle(new SubscriptionHandle(tracking));
+    std::weak_ptr<SubscriptionHandle> handler_handle = caller_handle;
+    auto strand = std::make_shared<Strand>(pool);
+    locked([&]() {
+        const Subscription token = m_store.subscribe([strand, op, handler_handle]() {
+            postTracked(*strand, handler_handle, op);
+        });
+        m_store.tie(token, caller_handle);
+    });
+    return caller_handle;
+}
+
+template <class S, class A, class R>
+template <class Selector, class F, class Equal>
+std::shared_ptr<ReduCxx::SubscriptionHandle>
+ReduCxx::AsyncStore<S, A, R>::subscribeAsync(ReduCxx::ThreadPool& pool, const TrackingPolicy& tracking,
+                                             const Selector& selector, const F &op, const Equal& equal) {
+    std::shared_ptr<SubscriptionHandle> caller_handle(new SubscriptionHandle(tracking));
+    std::weak_ptr<SubscriptionHandle> handler_handle = caller_handle;
+    auto strand = std::make_shared<Strand>(pool);
+    locked([&]() {
+        const Subscription token = m_store.subscribe(selector, [strand, op, handler_handle](const auto& slice) {
+            postTracked(*strand, handler_handle, [op, slice]() mutable { op(slice); });
+        }, equal);
+        m_store.tie(token, caller_handle);
     });
     return caller_handle;
 }
@@ -0,0 +1,63 @@
+#ifndef REDUCXX_DISPATCH_POLICY_HPP
+#define REDUCXX_DISPATCH_POLICY_HPP
+
+#include "Priority.hpp"
+#include "QueuePolicy.hpp"
+
+namespace ReduCxx {
+    class DispatchPolicy;
+}
+
+/**
+ * @brief Describe how an AsyncStore processes the dispatched actions on its
+ * reducers thread.
+ */
+class ReduCxx::DispatchPolicy {
+public:
+
+    //! Each action is reduced by its own job, subscriptions run after each one
+    static DispatchPolicy sequential() { return DispatchPolicy(false); }
+
+    /**
+     * @brief Actions queued while the reducers thread is busy are reduced
+     * together, taking the state lock once, and subscriptions run once with
+     * the final state. Each dispatch still gets its own future.
+     */
+    static DispatchPolicy coalesced() { return DispatchPolicy(true); }
+
+    /**
+     * @brief Return a copy of this policy serving the priority lanes of the
+     * dispatches as told by @a lanes (strictly by default).
+     */
+    [[nodiscard]] DispatchPolicy withLanes(const LanePolicy& lanes) const {
+        DispatchPolicy policy(*this);
+        policy.m_lanes = lanes;
+        return policy;
+    }
+
+    /**
+     * @brief Return a copy of this policy bounding the dispatches queued for
+     * the reducers thread as told by @a queue (unbounded by default).
+     * Only for sequential dispatches: in coalesced mode the queued actions
+     * are reduced together, the queue is not bounded.
+     */
+    [[nodiscard]] DispatchPolicy withQueue(const QueuePolicy& queue) const {
+        DispatchPolicy policy(*this);
+        policy.m_queue = queue;
+        return policy;
+    }
+
+    [[nodiscard]] bool isCoalesced() const { return m_coalesced; }
+    [[nodiscard]] const LanePolicy& lanes() const { return m_lanes; }
+    [[nodiscard]] const QueuePolicy& queue() const { return m_queue; }
+
+private:
+    explicit DispatchPolicy(bool coalesced)
+        : m_coalesced(coalesced), m_lanes(LanePolicy::strict()), m_queue(QueuePolicy::unbounded()) { }
+
+    bool m_coalesced;
+    LanePolicy m_lanes;
+    QueuePolicy m_queue;
+};
+
+#endif //REDUCXX_DISPATCH_POLICY_HPP
@@ -0,0 +1,237 @@
+#ifndef REDUCXX_METRICS_HPP
+#define REDUCXX_METRICS_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Set REDUCXX_METRICS to 1 (the ENABLE_METRICS CMake option) to record the
+ * latencies of the dispatches of the async stores and the depth of the
+ * queues of their active objects. Otherwise the instrumentation is compiled
+ * out, and @a metrics() only returns empty results.
+ * It shall have the same value in all the translation units of a program.
+ */
+#ifndef REDUCXX_METRICS
+#define REDUCXX_METRICS 0
+#endif
+
+namespace ReduCxx {
+    class LatencyHistogram;
+
+    struct QueueMetrics;
+
+    struct DispatchMetrics;
+
+    namespace _impl {
+        class AtomicHistogram;
+
+        class DispatchRecorder;
+    }
+
+    //! Whether the metrics are recorded, see REDUCXX_METRICS
+    constexpr bool METRICS_ENABLED = REDUCXX_METRICS != 0;
+}
+
+/**
+ * @brief Distribution of latencies, as read from a recording histogram.
+ * Latencies are counted in log-linear buckets, each power of two being split
+ * into 16 buckets: a percentile is reported with an error below 1/16 of its
+ * value, whatever its magnitude.
+ */
+class ReduCxx::LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BITS = 4;
+    static constexpr std::size_t SUB_BUCKETS = std::size_t(1) << SUB_BITS;
+    static constexpr std::size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+    LatencyHistogram() = default;
+
+    //! Number of latencies recorded
+    [[nodiscard]] std::uint64_t count() const { return m_count; }
+
+    [[nodiscard]] std::chrono::nanoseconds max() const { return std::chrono::nanoseconds(m_max); }
+
+    [[nodiscard]] std::chrono::nanoseconds mean() const {
+        return std::chrono::nanoseconds(m_count > 0 ? m_sum / m_count : 0);
+    }
+
+    /**
+     * @brief Latency below which @a percent percents of the recorded ones
+     * fall, rounded up to the end of its bucket; zero if none was recorded.
+     */
+    [[nodiscard]] std::chrono::nanoseconds percentile(double percent) const;
+
+    //! Add the latencies of @a other, as if recorded by this histogram too
+    LatencyHistogram& operator +=(const LatencyHistogram& other);
+
+    //! Bucket of latency @a ns
+    static std::size_t bucketOf(std::uint64_t ns) {
+        if (ns < SUB_BUCKETS) {
+            return static_cast<std::size_t>(ns);
+        }
+        const unsigned shift = msb(ns) - SUB_BITS;
+        return (shift + 1) * SUB_BUCKETS + static_cast<std::size_t>((ns >> shift) - SUB_BUCKETS);
+    }
+
+    //! Highest latency counted in @a bucket
+    static std::uint64_t highestOf(std::size_t bucket) {
+        if (bucket < SUB_BUCKETS) {
+            return bucket;
+        }
+        const unsigned shift = static_cast<unsigned>(bucket / SUB_BUCKETS - 1);
+        const std::uint64_t lowest = static_cast<std::uint64_t>(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+        return lowest + ((std::uint64_t(1) << shift) - 1);
+    }
+
+private:
+    friend class _impl::AtomicHistogram;
+
+    std::vector<std::uint64_t> m_buckets;   // up to the last non empty one
+    std::uint64_t m_count = 0;
+    std::uint64_t m_sum = 0;
+    std::uint64_t m_max = 0;
+
+    static unsigned msb(std::uint64_t value) {
+#if defined __GNUC__
+        return 63 - static_cast<unsigned>(__builtin_clzll(value));
+#else
+        unsigned bit = 0;
+        while (value >>= 1) {
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+};
+
+//! @brief Occupancy of the queue of an ActiveObject, over all its lanes
+struct ReduCxx::QueueMetrics {
+    std::size_t depth = 0;          //!< jobs queued and not started yet
+    std::size_t highWater = 0;      //!< highest depth reached so far
+};
+
+/**
+ * @brief Latencies of the dispatches completed by an AsyncStore, all the
+ * actions of a batch counting as one dispatch. Dispatches that threw, from
+ * reducers or synchronous subscriptions, are not recorded.
+ * In coalesced mode a dispatch waits until the whole pending set is
+ * collected, and the subscriptions, run once for all of it, are recorded for
+ * each of its dispatches.
+ */
+struct ReduCxx::DispatchMetrics {
+    LatencyHistogram queueWait;     //!< from the dispatch call to the start of its reduction
+    LatencyHistogram reduce;        //!< running the reducers, and publishing the new state unless coalesced
+    LatencyHistogram subscriptions; //!< running the synchronous subscriptions after the reduction
+    LatencyHistogram total;         //!< from the dispatch call to its completion
+    QueueMetrics queue;             //!< of the reducers thread
+};
+
+/**
+ * @internal
+ * @brief Histogram recorded by a single thread without locks, to be read by
+ * other threads meanwhile: a read may miss the latencies being recorded, but
+ * never sees a partial one in the buckets.
+ * Having a single writer, recording needs no read-modify-write instruction.
+ */
+class ReduCxx::_impl::AtomicHistogram {
+public:
+    void record(std::chrono::nanoseconds latency) {
+        const std::uint64_t ns = static_cast<std::uint64_t>(std::max<std::int64_t>(latency.count(), 0));
+        increase(m_buckets[LatencyHistogram::bucketOf(ns)], 1);
+        increase(m_sum, ns);
+        if (ns > m_max.load(std::memory_order_relaxed)) {
+            m_max.store(ns, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] LatencyHistogram snapshot() const {
+        LatencyHistogram result;
+        std::size_t used = 0;
+        std::array<std::uint64_t, LatencyHistogram::BUCKETS> counts;
+        for (std::size_t i = 0; i < counts.size(); ++i) {
+            counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+            result.m_count += counts[i];
+            used = counts[i] > 0 ? i + 1 : used;
+        }
+        result.m_buckets.assign(counts.begin(), counts.begin() + used);
+        result.m_sum = m_sum.load(std::memory_order_relaxed);
+        result.m_max = m_max.load(std::memory_order_relaxed);
+        return result;
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, LatencyHistogram::BUCKETS> m_buckets {};
+    std::atomic<std::uint64_t> m_sum { 0 };
+    std::atomic<std::uint64_t> m_max { 0 };
+
+    static void increase(std::atomic<std::uint64_t>& counter, std::uint64_t by) {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @internal
+ * @brief The histograms of DispatchMetrics, recorded by the reducers thread
+ * of an AsyncStore.
+ */
+class ReduCxx::_impl::DispatchRecorder {
+public:
+    using clock = std::chrono::steady_clock;
+
+    void record(clock::time_point posted, clock::time_point started, clock::duration reduce,
+                clock::duration subscriptions, clock::time_point done) {
+        m_queue_wait.record(started - posted);
+        m_reduce.record(reduce);
+        m_subscriptions.record(subscriptions);
+        m_total.record(done - posted);
+    }
+
+    [[nodiscard]] DispatchMetrics snapshot(const QueueMetrics& queue) const {
+        return { m_queue_wait.snapshot(), m_reduce.snapshot(), m_subscriptions.snapshot(), m_total.snapshot(),
+                 queue };
+    }
+
+private:
+    AtomicHistogram m_queue_wait;
+    AtomicHistogram m_reduce;
+    AtomicHistogram m_subscriptions;
+    AtomicHistogram m_total;
+};
+
+inline std::chrono::nanoseconds ReduCxx::LatencyHistogram::percentile(double percent) const {
+    if (m_count == 0) {
+        return std::chrono::nanoseconds(0);
+    }
+    const double clamped = std::min(std::max(percent, 0.0), 100.0);
+    const std::uint64_t rank = std::max<std::uint64_t>(
+        static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(m_count))), 1);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < m_buckets.size(); ++i) {
+        seen += m_buckets[i];
+        if (seen >= rank) {
+            return std::chrono::nanoseconds(std::min(highestOf(i), m_max));
+        }
+    }
+    return max();
+}
+
+inline ReduCxx::LatencyHistogram& ReduCxx::LatencyHistogram::operator +=(const LatencyHistogram& other) {
+    if (m_buckets.size() < other.m_buckets.size()) {
+        m_buckets.resize(other.m_buckets.size(), 0);
+    }
+    for (std::size_t i = 0; i < other.m_buckets.size(); ++i) {
+        m_buckets[i] += other.m_buckets[i];
+    }
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_max = std::max(m_max, other.m_max);
+    return *this;
+}
+
+#endif //REDUCXX_METRICS_HPP
@@ -0,0 +1,87 @@
+#ifndef REDUCXX_MPSC_QUEUE_HPP
+#define REDUCXX_MPSC_QUEUE_HPP
+
+#include "NodePool.hpp"
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace ReduCxx {
+    namespace _impl {
+        template <class T>
+        class MpscQueue;
+    }
+}
+
+/**
+ * @internal
+ * @brief Unbounded lock-free multi-producer single-consumer queue (after
+ * Dmitry Vyukov's node based one).
+ * Producers only exchange the head pointer, the consumer owns the tail: a
+ * push is wait-free, a pop never blocks but may miss an element whose push is
+ * still in progress (then @a empty() is false while @a pop() returns nothing).
+ * Nodes are recycled through a pool, so that once it has grown to the peak
+ * queue length pushing does not allocate.
+ */
+template <class T>
+class ReduCxx::_impl::MpscQueue {
+public:
+    MpscQueue() : m_tail(m_pool.make()) {
+        m_head.store(m_tail, std::memory_order_relaxed);
+    }
+
+    //! Steal the elements of @a temp, which must not be in use anymore
+    MpscQueue(MpscQueue&& temp) noexcept
+        : m_pool(std::move(temp.m_pool))
+        , m_tail(std::exchange(temp.m_tail, nullptr)) {
+        m_head.store(temp.m_head.exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator =(const MpscQueue&) = delete;
+
+    ~MpscQueue() {
+        while (m_tail) {
+            m_pool.recycle(std::exchange(m_tail, m_tail->next.load(std::memory_order_relaxed)));
+        }
+    }
+
+    //! Can be called concurrently by any number of threads
+    void push(T&& value) {
+        Node* node = m_pool.make(std::move(value));
+        Node* prev = m_head.exchange(node); // seq_cst, pairs with empty()
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    //! Consumer only: take the oldest element, if any
+    std::optional<T> pop() {
+        Node* next = m_tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return std::nullopt;
+        }
+        std::optional<T> value(std::move(next->value));
+        next->value.reset();        // next becomes the new (empty) tail
+        m_pool.recycle(std::exchange(m_tail, next));
+        return value;
+    }
+
+    //! Consumer only: true if no element was pushed, even partially
+    bool empty() const {
+        return m_tail->next.load(std::memory_order_acquire) == nullptr && m_head.load() == m_tail;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next { nullptr };
+        std::optional<T> value;
+
+        Node() = default;
+        explicit Node(T&& value) : value(std::move(value)) { }
+    };
+
+    NodePool<Node> m_pool;
+    std::atomic<Node*> m_head;  // last pushed node, shared by producers
+    Node* m_tail;               // node preceding the oldest element, owned by the consumer
+};
+
+#endif //REDUCXX_MPSC_QUEUE_HPP
@@ -0,0 +1,213 @@
+#ifndef REDUCXX_NODE_POOL_HPP
+#define REDUCXX_NODE_POOL_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace ReduCxx {
+    namespace _impl {
+        template <class T>
+        class NodePool;
+
+        class BlockPool;
+
+        template <class T>
+        class PoolAllocator;
+    }
+}
+
+/**
+ * @internal
+ * @brief Thread-safe pool recycling the storage of objects of type @a T, used
+ * to avoid a heap allocation per queued element.
+ * Free slots are kept in a lock-free stack of indices tagged against the ABA
+ * problem; the pool grows by chunks (each one twice the size of the previous
+ * one) under a lock, and never shrinks until destroyed.
+ */
+template <class T>
+class ReduCxx::_impl::NodePool {
+public:
+    NodePool() = default;
+
+    //! Steal the slots of @a temp, which must not be in use anymore
+    NodePool(NodePool&& temp) noexcept
+        : m_free(temp.m_free.exchange(0, std::memory_order_relaxed))
+        , m_chunks(temp.m_chunks.exchange(0, std::memory_order_relaxed)) {
+        for (std::size_t k = 0; k < MAX_CHUNKS; ++k) {
+            m_chunk[k].store(temp.m_chunk[k].exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+    }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator =(const NodePool&) = delete;
+
+    ~NodePool() {
+        for (std::size_t k = 0; k < MAX_CHUNKS; ++k) {
+            delete[] m_chunk[k].load(std::memory_order_relaxed);
+        }
+    }
+
+    //! Build a @a T out of @a args in a recycled slot
+    template <class... Args>
+    T* make(Args&&... args) {
+        Slot* slot = pop();
+        while (!slot) {
+            grow();
+            slot = pop();
+        }
+        try {
+            if constexpr (sizeof...(Args) == 0) {
+                return new (slot->storage) T;   // no zeroing of raw blocks
+            } else {
+                return new (slot->storage) T(std::forward<Args>(args)...);
+            }
+        } catch (...) {
+            push(slot);
+            throw;
+        }
+    }
+
+    //! Destroy @a object, previously built by @a make, and recycle its slot
+    void recycle(T* object) noexcept {
+        object->~T();
+        push(reinterpret_cast<Slot*>(object));  // storage is the first member of Slot
+    }
+
+private:
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        std::atomic<std::uint32_t> next;    // index + 1 of the next free slot, 0 for none
+        std::uint32_t index;
+    };
+
+    static constexpr std::size_t FIRST_CHUNK = 64;
+    static constexpr std::size_t MAX_CHUNKS = 24;  // about a billion slots
+
+    std::atomic<std::uint64_t> m_free { 0 };    // tag << 32 | (index + 1) of the top free slot
+    std::atomic<std::size_t> m_chunks { 0 };
+    std::array<std::atomic<Slot*>, MAX_CHUNKS> m_chunk {};
+    std::mutex m_growth;
+
+    //! Chunk k holds slots [FIRST_CHUNK * (2^k - 1), FIRST_CHUNK * (2^(k+1) - 1))
+    Slot* at(std::uint32_t index) const {
+        const std::size_t q = index / FIRST_CHUNK + 1;
+        std::size_t k = 0;
+        while (q >> (k + 1)) {
+            ++k;
+        }
+        return m_chunk[k].load(std::memory_order_acquire) + (index - FIRST_CHUNK * ((std::size_t(1) << k) - 1));
+    }
+
+    Slot* pop() {
+        std::uint64_t top = m_free.load(std::memory_order_acquire);
+        while (std::uint32_t(top) != 0) {
+            Slot* slot = at(std::uint32_t(top) - 1);
+            const std::uint64_t next = ((top >> 32) + 1) << 32 | slot->next.load(std::memory_order_relaxed);
+            if (m_free.compare_exchange_weak(top, next, std::memory_order_acquire, std::memory_order_acquire)) {
+                return slot;
+            }
+        }
+        return nullptr;
+    }
+
+    void push(Slot* slot) noexcept {
+        std::uint64_t top = m_free.load(std::memory_order_relaxed);
+        std::uint64_t next;
+        do {
+            slot->next.store(std::uint32_t(top), std::memory_order_relaxed);
+            next = ((top >> 32) + 1) << 32 | (slot->index + 1);
+        } while (!m_free.compare_exchange_weak(top, next, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void grow() {
+        std::unique_lock<std::mutex> lock(m_growth);
+        if (std::uint32_t(m_free.load(std::memory_order_acquire)) != 0) {
+            return;     // somebody else grew the pool meanwhile
+        }
+        const std::size_t k = m_chunks.load(std::memory_order_relaxed);
+        if (k == MAX_CHUNKS) {
+            throw std::bad_alloc();
+        }
+        const std::size_t size = FIRST_CHUNK << k;
+        const std::size_t first = FIRST_CHUNK * ((std::size_t(1) << k) - 1);
+        std::unique_ptr<Slot[]> chunk(new Slot[size]);
+        for (std::size_t i = 0; i < size; ++i) {
+            chunk[i].index = static_cast<std::uint32_t>(first + i);
+        }
+        m_chunk[k].store(chunk.get(), std::memory_order_release);
+        m_chunks.store(k + 1, std::memory_order_relaxed);
+        Slot* slots = chunk.release();
+        for (std::size_t i = size; i > 0; --i) {
+            push(&slots[i - 1]);
+        }
+    }
+};
+
+/**
+ * @internal
+ * @brief Pool of fixed size memory blocks, for small allocations of any type
+ * (such as the shared state of promises); bigger ones go to the heap.
+ */
+class ReduCxx::_impl::BlockPool {
+public:
+    static constexpr std::size_t BLOCK_SIZE = 128;
+
+    void* allocate(std::size_t size, std::size_t alignment) {
+        if (size > BLOCK_SIZE || alignment > alignof(Block)) {
+            return ::operator new(size);
+        }
+        return m_blocks.make();
+    }
+
+    void deallocate(void* ptr, std::size_t size, std::size_t alignment) noexcept {
+        if (size > BLOCK_SIZE || alignment > alignof(Block)) {
+            ::operator delete(ptr);
+            return;
+        }
+        m_blocks.recycle(static_cast<Block*>(ptr));
+    }
+
+private:
+    struct alignas(std::max_align_t) Block {
+        unsigned char bytes[BLOCK_SIZE];
+    };
+
+    NodePool<Block> m_blocks;
+};
+
+/**
+ * @internal
+ * @brief Standard allocator drawing from a shared @a BlockPool, which lives
+ * as long as anything allocated from it.
+ */
+template <class T>
+class ReduCxx::_impl::PoolAllocator {
+public:
+    typedef T value_type;
+
+    explicit PoolAllocator(std::shared_ptr<BlockPool> pool) noexcept : m_pool(std::move(pool)) { }
+
+    template <class U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept : m_pool(other.pool()) { } // NOLINT: rebinding
+
+    T* allocate(std::size_t n) { return static_cast<T*>(m_pool->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T* ptr, std::size_t n) noexcept { m_pool->deallocate(ptr, n * sizeof(T), alignof(T)); }
+
+    [[nodiscard]] const std::shared_ptr<BlockPool>& pool() const noexcept { return m_pool; }
+
+    template <class U>
+    bool operator ==(const PoolAllocator<U>& other) const noexcept { return m_pool == other.pool(); }
+    template <class U>
+    bool operator !=(const PoolAllocator<U>& other) const noexcept { return m_pool != other.pool(); }
+
+private:
+    std::shared_ptr<BlockPool> m_pool;
+};
+
+#endif //REDUCXX_NODE_POOL_HPP
@@ -0,0 +1,204 @@
+#ifndef REDUCXX_PARALLEL_COMPOSER_HPP
+#define REDUCXX_PARALLEL_COMPOSER_HPP
+
+#include "ReduCxx/Composer.hpp"
+#include "ThreadPool.hpp"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+namespace ReduCxx
+{
+    template <class A, class... Reducers>
+    class ParallelComposer;
+} // namespace ReduCxx
+
+/**
+ * @brief Composer running its reducers concurrently on a ThreadPool, for
+ * composite states whose reducers are heavy enough (sorting, rebuilding
+ * indices...) to outweigh the cost of handing them over to other threads.
+ * The calling thread runs the first reducer, then any reducer no worker has
+ * picked up yet, and waits for the others; reducers are routed as by the
+ * plain Composer.
+ *
+ * Reduction is all or nothing: reducers only read the previous state, even
+ * when the Store lets it be consumed, and if any of them throws the first
+ * exception (in reducers order) is rethrown once they are all done.
+ * @warning Reducers shall not touch shared resources, and @a pool shall
+ * outlive the composer.
+ */
+template <class A, class... Reducers>
+class ReduCxx::ParallelComposer
+{
+  public:
+    using ReducersTuple = std::tuple<std::decay_t<Reducers>...>;
+    using CompositeState = typename Composer<A, Reducers...>::CompositeState;
+
+    ParallelComposer(ThreadPool &pool, const Reducers &... reducers)
+        : m_pool(&pool), m_reducers(reducers...) {}
+
+    CompositeState operator()(const CompositeState &state, const A &action) const
+    {
+        DirtyMask dirty;
+        return (*this)(state, action, dirty);
+    }
+
+    CompositeState operator()(const CompositeState &state, const A &action, DirtyMask &dirty) const
+    {
+        return apply(state, action, dirty, std::index_sequence_for<Reducers...>{});
+    }
+
+    //! Same as above: the previous state is only moved from once the whole reduction succeeded
+    CompositeState operator()(CompositeState &&state, const A &action, DirtyMask &dirty) const
+    {
+        return apply(std::move(state), action, dirty, std::index_sequence_for<Reducers...>{});
+    }
+
+  private:
+    static constexpr std::size_t SIZE = sizeof...(Reducers);
+
+    static_assert(SIZE <= 8 * sizeof(DirtyMask), "too many reducers to track their changes");
+
+    template <std::size_t I>
+    using Route = _impl::RouteTraits<std::tuple_element_t<I, ReducersTuple>>;
+
+    //! A reduction in progress, shared with the pool tasks that may outlive it
+    struct Batch
+    {
+        const ParallelComposer *composer;
+        const CompositeState *state;    // only read by the tasks claiming a reducer, which the caller waits for
+        const A *action;
+        std::tuple<std::optional<typename _impl::ReducerTraits<Reducers>::State_t>...> next;
+        std::array<bool, SIZE> changed{};
+        std::array<std::exception_ptr, SIZE> errors{};
+        std::array<std::atomic<bool>, SIZE> claimed{};
+        std::atomic<std::size_t> remaining{0};
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+
+    ThreadPool *m_pool;
+    const ReducersTuple m_reducers;
+
+    template <std::size_t I>
+    bool handles(const A &action) const
+    {
+        if constexpr (Route<I>::Routed)
+        {
+            return Route<I>::handles(action.type());
+        }
+        else
+        {
+            return true;
+        }
+    }
+
+    //! Run reducer @a I unless somebody else already did
+    template <std::size_t I>
+    static void run(Batch &batch)
+    {
+        if (batch.claimed[I].exchange(true))
+        {
+            return;
+        }
+        try
+        {
+            bool changed = true;
+            std::get<I>(batch.next).emplace(_impl::reduce(std::get<I>(batch.composer->m_reducers),
+                                                          std::get<I>(*batch.state), *batch.action, &changed));
+            batch.changed[I] = changed;
+        }
+        catch (...)
+        {
+            batch.errors[I] = std::current_exception();
+        }
+        if (batch.remaining.fetch_sub(1) == 1)
+        {
+            std::unique_lock<std::mutex> lock(batch.mutex);
+            batch.done.notify_one();
+        }
+    }
+
+    template <class State, std::size_t... Is>
+    CompositeState apply(State &&state, const A &action, DirtyMask &dirty, std::index_sequence<Is...>) const
+    {
+        auto batch = std::make_shared<Batch>();
+        batch->composer = this;
+        batch->state = &state;
+        batch->action = &action;
+        const std::array<bool, SIZE> invoked{handles<Is>(action)...};
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < SIZE; ++i)
+        {
+            batch->claimed[i].store(!invoked[i], std::memory_order_relaxed);
+            count += invoked[i];
+        }
+        batch->remaining.store(count);
+
+        // hand all the reducers but the first invoked one over to the pool
+        static constexpr void (*RUN[])(Batch &) = {&ParallelComposer::run<Is>...};
+        std::size_t first = 0;
+        while (first < SIZE && !invoked[first])
+        {
+            ++first;
+        }
+        try
+        {
+            for (std::size_t i = first + 1; i < SIZE; ++i)
+            {
+                if (invoked[i])
+                {
+                    m_pool->execute([batch, run = RUN[i]]() { run(*batch); });
+                }
+            }
+        }
+        catch (...)
+        {
+            // the reducers not handed over are run below
+        }
+        for (std::size_t i = first; i < SIZE; ++i)
+        {
+            RUN[i](*batch);     // a no-op for the reducers claimed by a worker
+        }
+        {
+            std::unique_lock<std::mutex> lock(batch->mutex);
+            batch->done.wait(lock, [&]() { return batch->remaining.load() == 0; });
+        }
+
+        for (const std::exception_ptr &error : batch->errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+        dirty = (DirtyMask(0) | ... | (DirtyMask(invoked[Is] && batch->changed[Is]) << Is));
+        return CompositeState{pick<Is>(std::get<Is>(batch->next), std::forward<State>(state))...};
+    }
+
+    //! The new sub-state @a I if its reducer ran, the previous one otherwise
+    template <std::size_t I, class Slice, class State>
+    static auto pick(std::optional<Slice> &next, State &&state)
+    {
+        if (next)
+        {
+            return std::move(*next);
+        }
+        return Slice(std::get<I>(std::forward<State>(state)));
+    }
+};
+
+//! @internal a ParallelComposer is a reducer of its composite state too
+template <class A, class... Reducers>
+struct ReduCxx::_impl::ReducerTraits<ReduCxx::ParallelComposer<A, Reducers...>>
+    : ReducerTraits<typename ReduCxx::ParallelComposer<A, Reducers...>::CompositeState(
+          const typename ReduCxx::ParallelComposer<A, Reducers...>::CompositeState &, const A &)>
+{};
+
+#endif //REDUCXX_PARALLEL_COMPOSER_HPP
@@ -0,0 +1,54 @@
+#ifndef REDUCXX_PRIORITY_HPP
+#define REDUCXX_PRIORITY_HPP
+
+#include <array>
+#include <cstddef>
+
+namespace ReduCxx {
+    enum class Priority;
+
+    class LanePolicy;
+}
+
+/**
+ * @brief Lane of the queue of an ActiveObject (and of the dispatches of an
+ * AsyncStore) a job is posted to: jobs are served in order within a lane,
+ * lanes are served according to a @a LanePolicy.
+ */
+enum class ReduCxx::Priority {
+    HIGH,       //!< latency critical jobs, as control actions
+    NORMAL,
+    LOW         //!< bulk jobs that can wait
+};
+
+/**
+ * @brief Describe how the worker of an ActiveObject picks among its lanes.
+ */
+class ReduCxx::LanePolicy {
+public:
+    static constexpr std::size_t LANES = 3;
+
+    //! Always serve the highest priority lane with pending jobs: lower lanes may starve
+    static LanePolicy strict() { return LanePolicy({ 0, 0, 0 }); }
+
+    /**
+     * @brief Serve up to @a high jobs of the HIGH lane, then up to @a normal
+     * of the NORMAL one, then up to @a low of the LOW one, and so on: busy
+     * lanes get shares of the worker proportional to their weight (at least
+     * 1), so none of them starves.
+     */
+    static LanePolicy weighted(unsigned high, unsigned normal, unsigned low) {
+        return LanePolicy({ high > 0 ? high : 1, normal > 0 ? normal : 1, low > 0 ? low : 1 });
+    }
+
+    [[nodiscard]] bool isStrict() const { return m_weights[0] == 0; }
+
+    [[nodiscard]] unsigned weight(Priority priority) const { return m_weights[static_cast<std::size_t>(priority)]; }
+
+private:
+    explicit LanePolicy(const std::array<unsigned, LANES>& weights) : m_weights(weights) { }
+
+    std::array<unsigned, LANES> m_weights;
+};
+
+#endif //REDUCXX_PRIORITY_HPP
@@ -0,0 +1,18 @@
+#ifndef REDUCXX_QUEUE_FULL_ERROR_HPP
+#define REDUCXX_QUEUE_FULL_ERROR_HPP
+
+#include <stdexcept>
+
+namespace ReduCxx
+{
+    class QueueFullError;
+}
+
+//! A job was rejected, or dropped, by a full ActiveObject, see @a QueuePolicy
+class ReduCxx::QueueFullError : public std::runtime_error
+{
+  public:
+    QueueFullError() : runtime_error("queue full, job rejected") {}
+};
+
+#endif //REDUCXX_QUEUE_FULL_ERROR_HPP
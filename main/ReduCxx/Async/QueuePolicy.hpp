@@ -0,0 +1,49 @@
+#ifndef REDUCXX_QUEUE_POLICY_HPP
+#define REDUCXX_QUEUE_POLICY_HPP
+
+#include <cstddef>
+#include <limits>
+
+namespace ReduCxx
+{
+    class QueuePolicy;
+}
+
+/**
+ * @brief Describe how many jobs an ActiveObject queues (over all its lanes)
+ * and what happens to the jobs posted while it is full.
+ */
+class ReduCxx::QueuePolicy
+{
+  public:
+    static constexpr std::size_t UNBOUNDED = std::numeric_limits<std::size_t>::max();
+
+    enum class Overflow
+    {
+        BLOCK,          //!< the producer waits for room
+        FAIL,           //!< the producer gets a QueueFullError thrown
+        DROP_OLDEST,    //!< the oldest job of the lowest priority lane is dropped
+        DROP_NEWEST     //!< the new job is dropped
+    };
+
+    //! Queue any number of jobs (the memory grows without limit)
+    static QueuePolicy unbounded() { return QueuePolicy(UNBOUNDED, Overflow::BLOCK); }
+
+    //! Queue at most @a capacity jobs, handling the other ones as told by @a overflow
+    static QueuePolicy bounded(std::size_t capacity, Overflow overflow = Overflow::BLOCK)
+    { return QueuePolicy(capacity > 0 ? capacity : 1, overflow); }
+
+    [[nodiscard]] std::size_t capacity() const { return m_capacity; }
+    [[nodiscard]] bool isBounded() const { return m_capacity != UNBOUNDED; }
+    [[nodiscard]] Overflow overflow() const { return m_overflow; }
+
+  private:
+    QueuePolicy(std::size_t capacity, Overflow overflow)
+        : m_capacity(capacity), m_overflow(overflow)
+    { }
+
+    std::size_t m_capacity;
+    Overflow m_overflow;
+};
+
+#endif //REDUCXX_QUEUE_POLICY_HPP
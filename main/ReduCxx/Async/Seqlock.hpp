@@ -0,0 +1,215 @@
+#ifndef REDUCXX_SEQLOCK_HPP
+#define REDUCXX_SEQLOCK_HPP
+
+#include "ReduCxx/Composer.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ReduCxx {
+    namespace _impl {
+        template <class T>
+        class Seqlock;
+
+        template <class T>
+        struct SeqlockEligible;
+
+        template <class S>
+        class SeqlockSlices;
+    }
+}
+
+/**
+ * @internal
+ * @brief Single writer, multiple readers sequence lock around a copy of a
+ * trivially copyable @a T.
+ * Readers never take a lock and never write shared memory: they copy the
+ * value and retry if a write overlapped; the writer never waits for readers.
+ * The value is kept in atomic words so that overlapping copies are not data
+ * races.
+ */
+template <class T>
+class ReduCxx::_impl::Seqlock {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "Seqlock requires a trivially copyable type");
+
+    explicit Seqlock(const T& value) {
+        store(value);
+    }
+
+    Seqlock(Seqlock&& temp) noexcept {
+        store(temp.load());
+    }
+
+    Seqlock(const Seqlock&) = delete;
+    Seqlock& operator =(const Seqlock&) = delete;
+
+    //! Writer only
+    void store(const T& value) {
+        std::array<std::uint64_t, WORDS> words {};
+        std::memcpy(words.data(), &value, sizeof(T));
+        const std::uint64_t sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);     // odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < WORDS; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    T load() const {
+        std::array<std::uint64_t, WORDS> words;
+        for (;;) {
+            const std::uint64_t before = m_sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                std::this_thread::yield();  // the writer may have been preempted
+                continue;
+            }
+            for (std::size_t i = 0; i < WORDS; ++i) {
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_sequence.load(std::memory_order_relaxed) == before) {
+                break;
+            }
+        }
+        T value;
+        std::memcpy(&value, words.data(), sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr std::size_t WORDS = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    std::atomic<std::uint64_t> m_sequence { 0 };
+    std::array<std::atomic<std::uint64_t>, WORDS> m_words {};
+};
+
+/**
+ * @internal
+ * @brief Whether a state (or a slice of it) is read through a Seqlock: it has
+ * to be trivially copyable and small enough for readers to rarely overlap a
+ * write.
+ */
+template <class T>
+struct ReduCxx::_impl::SeqlockEligible
+    : std::bool_constant<std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T> && sizeof(T) <= 256> {};
+
+/**
+ * @internal
+ * @brief Seqlock copy of a state, when eligible: a std::tuple state is never
+ * trivially copyable, so each eligible sub-state gets its own Seqlock instead,
+ * republished only when dirty.
+ */
+template <class S>
+class ReduCxx::_impl::SeqlockSlices {
+public:
+    static constexpr bool WHOLE = SeqlockEligible<S>::value;
+
+    template <std::size_t I>
+    static constexpr bool SLICE = false;
+
+    template <class T>
+    static constexpr bool SLICE_OF = false;
+
+    explicit SeqlockSlices(const S& state) : m_whole(state) { }
+
+    void publish(const S& state, DirtyMask dirty) {
+        if constexpr (WHOLE) {
+            if (dirty != 0) {
+                m_whole.store(state);
+            }
+        }
+    }
+
+    S load() const { return m_whole.load(); }
+
+private:
+    struct None {
+        explicit None(const S&) { }
+        void store(const S&) { }
+        S load() const { return S(); }
+    };
+
+    std::conditional_t<WHOLE, Seqlock<S>, None> m_whole;
+};
+
+template <class... Ts>
+class ReduCxx::_impl::SeqlockSlices<std::tuple<Ts...>> {
+public:
+    static constexpr bool WHOLE = false;
+
+    template <std::size_t I>
+    static constexpr bool SLICE = SeqlockEligible<std::tuple_element_t<I, std::tuple<Ts...>>>::value;
+
+    //! Index of the first sub-state of type @a T
+    template <class T>
+    static constexpr std::size_t indexOf() {
+        constexpr bool same[] = { std::is_same_v<T, Ts>... };
+        std::size_t index = 0;
+        while (index < sizeof...(Ts) && !same[index]) {
+            ++index;
+        }
+        return index < sizeof...(Ts) ? index : 0;   // when missing, SLICE_OF is false anyway
+    }
+
+    //! Whether the sub-state of type @a T, provided there is only one, has a Seqlock
+    template <class T>
+    static constexpr bool SLICE_OF = (0 + ... + std::is_same_v<T, Ts>) == 1 && SLICE<indexOf<T>()>;
+
+    explicit SeqlockSlices(const std::tuple<Ts...>& state)
+        : SeqlockSlices(state, std::index_sequence_for<Ts...>())
+    { }
+
+    void publish(const std::tuple<Ts...>& state, DirtyMask dirty) {
+        publish(state, dirty, std::index_sequence_for<Ts...>());
+    }
+
+    template <std::size_t I>
+    std::tuple_element_t<I, std::tuple<Ts...>> load() const {
+        return std::get<I>(m_slices).load();
+    }
+
+    template <class T>
+    T load() const {
+        return load<indexOf<T>()>();
+    }
+
+private:
+    struct None {
+        template <class T>
+        explicit None(const T&) { }
+    };
+
+    template <class T>
+    using Slot = std::conditional_t<SeqlockEligible<T>::value, Seqlock<T>, None>;
+
+    std::tuple<Slot<Ts>...> m_slices;
+
+    template <std::size_t... Is>
+    SeqlockSlices(const std::tuple<Ts...>& state, std::index_sequence<Is...>)
+        : m_slices(std::get<Is>(state)...)
+    { }
+
+    template <std::size_t... Is>
+    void publish(const std::tuple<Ts...>& state, DirtyMask dirty, std::index_sequence<Is...>) {
+        auto slice = [&](auto index) {
+            constexpr std::size_t I = decltype(index)::value;
+            if constexpr (SLICE<I>) {
+                if ((dirty >> I) & 1) {
+                    std::get<I>(m_slices).store(std::get<I>(state));
+                }
+            }
+        };
+        (slice(std::integral_constant<std::size_t, Is>()), ...);
+    }
+};
+
+#endif //REDUCXX_SEQLOCK_HPP
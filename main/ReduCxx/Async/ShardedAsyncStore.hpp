@@ -0,0 +1,179 @@
+#ifndef REDUCXX_SHARDED_ASYNC_STORE_HPP
+#define REDUCXX_SHARDED_ASYNC_STORE_HPP
+
+#include "AsyncStore.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace ReduCxx {
+    template <class S, class A, class R = _impl::ErasedReducer<S, A>>
+    class ShardedAsyncStore;
+}
+
+/**
+ * @brief Set of AsyncStores, the shards, each one owning the partition of the
+ * state of the actions whose key maps to it.
+ * Every shard has its own reducers thread, so that actions on different
+ * shards are reduced in parallel, while actions of the same key are still
+ * reduced one at a time and in order. Each shard starts from a default @a S
+ * and only sees the actions of its own keys: @a S is then typically a
+ * collection of per-key entries (accounts, sessions...).
+ */
+template <class S, class A, class R>
+class ReduCxx::ShardedAsyncStore {
+public:
+
+    /**
+     * @brief Build @a shards shards around given @a reducer.
+     * @param keyOf extract from an action the key deciding its shard, the key
+     * has to be hashable by std::hash
+     */
+    template <class F, class K>
+    ShardedAsyncStore(const F& reducer, const K& keyOf, std::size_t shards,
+                      const HistoryPolicy& history = HistoryPolicy::bounded(1),
+                      const DispatchPolicy& dispatch = DispatchPolicy::sequential())
+        : m_shard_of([keyOf](const A& action) {
+            const auto& key = keyOf(action);
+            return std::hash<std::decay_t<decltype(key)>>()(key);
+        }) {
+        for (std::size_t i = 0; i < std::max<std::size_t>(shards, 1); ++i) {
+            m_shards.push_back(std::make_unique<AsyncStore<S, A, R>>(reducer, history, dispatch));
+        }
+    }
+
+    ShardedAsyncStore(const ShardedAsyncStore&) = delete;
+    ShardedAsyncStore& operator =(const ShardedAsyncStore&) = delete;
+
+    //! @brief Number of shards
+    std::size_t size() const { return m_shards.size(); }
+
+    //! @brief Index of the shard @a action is dispatched to
+    std::size_t shardOf(const A& action) const { return m_shard_of(action) % m_shards.size(); }
+
+    //! @brief Shard of index @a i, to read its state or subscribe to it
+    AsyncStore<S, A, R>& shard(std::size_t i) { return *m_shards[i]; }
+    const AsyncStore<S, A, R>& shard(std::size_t i) const { return *m_shards[i]; }
+
+    //! @brief Dispatch @a action to its shard, see @a AsyncStore::dispatch
+    template <class Action>
+    std::future<void> dispatch(Action&& action, Priority priority = Priority::NORMAL) {
+        AsyncStore<S, A, R>& target = *m_shards[shardOf(action)];
+        return target.dispatch(std::forward<Action>(action), priority);
+    }
+
+    //! @brief Dispatch @a action to its shard, see @a AsyncStore::dispatchDetached
+    template <class Action>
+    void dispatchDetached(Action&& action, Priority priority = Priority::NORMAL) {
+        AsyncStore<S, A, R>& target = *m_shards[shardOf(action)];
+        target.dispatchDetached(std::forward<Action>(action), priority);
+    }
+
+    //! @brief Dispatch @a action to its shard, see @a AsyncStore::tryDispatch
+    std::optional<std::future<void>> tryDispatch(const A& action, Priority priority = Priority::NORMAL) {
+        return m_shards[shardOf(action)]->tryDispatch(action, priority);
+    }
+
+    //! @brief Number of dispatches rejected by all the shards, see @a AsyncStore::rejected
+    std::uint64_t rejected() const {
+        std::uint64_t count = 0;
+        for (const auto& shard : m_shards) {
+            count += shard->rejected();
+        }
+        return count;
+    }
+
+    /**
+     * @brief Metrics of all the shards merged, see @a AsyncStore::metrics;
+     * the queue depths are summed, as the high-water marks: reached at
+     * different times, their sum is an upper bound.
+     */
+    DispatchMetrics metrics() const {
+        DispatchMetrics merged;
+        for (const auto& shard : m_shards) {
+            const DispatchMetrics one = shard->metrics();
+            merged.queueWait += one.queueWait;
+            merged.reduce += one.reduce;
+            merged.subscriptions += one.subscriptions;
+            merged.total += one.total;
+            merged.queue.depth += one.queue.depth;
+            merged.queue.highWater += one.queue.highWater;
+        }
+        return merged;
+    }
+
+    //! @brief Set the error sink of every shard, see @a AsyncStore::setErrorSink
+    void setErrorSink(const typename ActiveObject<void>::error_sink& sink) {
+        for (const auto& shard : m_shards) {
+            shard->setErrorSink(sink);
+        }
+    }
+
+    /**
+     * @brief Return the states of all the shards at a single point in time.
+     * Every shard is stopped once done with the actions dispatched before the
+     * call, until the states of all of them are taken: the result never sees
+     * an action without the ones that completed before it was dispatched,
+     * whatever their shards, as long as they have the NORMAL priority.
+     * Reading a single shard through @a shard(i) is cheaper when consistency
+     * across shards is not needed. Concurrent snapshots are taken one at a
+     * time.
+     * @warning Do not call it from subscriptions, it waits for every shard.
+     */
+    std::vector<std::shared_ptr<const S>> snapshot() const;
+
+private:
+    //! Hold the threads arriving at it until all the expected ones did
+    class Barrier {
+    public:
+        explicit Barrier(std::size_t expected) : m_waiting(expected) { }
+
+        void arriveAndWait() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (--m_waiting == 0) {
+                m_all.notify_all();
+                return;
+            }
+            m_all.wait(lock, [&]() { return m_waiting == 0; });
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_all;
+        std::size_t m_waiting;
+    };
+
+    std::function<std::size_t(const A&)> m_shard_of;
+    std::vector<std::unique_ptr<AsyncStore<S, A, R>>> m_shards;
+    // two snapshots posting their barriers in different orders to the shards
+    // would each hold a shard waiting for the other one
+    mutable std::mutex m_snapshot_mutex;
+};
+
+template <class S, class A, class R>
+std::vector<std::shared_ptr<const S>> ReduCxx::ShardedAsyncStore<S, A, R>::snapshot() const {
+    std::lock_guard<std::mutex> lock(m_snapshot_mutex);
+    std::vector<std::shared_ptr<const S>> states(m_shards.size());
+    auto barrier = std::make_shared<Barrier>(m_shards.size());
+    std::vector<std::future<void>> taken;
+    taken.reserve(m_shards.size());
+    for (std::size_t i = 0; i < m_shards.size(); ++i) {
+        AsyncStore<S, A, R>* shard = m_shards[i].get();
+        taken.push_back(shard->post([shard, barrier, state = &states[i]]() {
+            *state = shard->snapshot();
+            barrier->arriveAndWait();
+        }));
+    }
+    for (std::future<void>& done : taken) {
+        done.get();
+    }
+    return states;
+}
+
+#endif //REDUCXX_SHARDED_ASYNC_STORE_HPP
@@ -0,0 +1,133 @@
+#ifndef REDUCXX_STATE_READER_HPP
+#define REDUCXX_STATE_READER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace ReduCxx {
+    template <class S>
+    class StateReader;
+
+    namespace _impl {
+        template <class S>
+        class SnapshotCell;
+    }
+}
+
+/**
+ * @internal
+ * @brief Holder of the last published, immutable state of an AsyncStore.
+ * Publishing swaps the snapshot under a lock held only for the swap, never
+ * during reductions; a generation counter lets readers caching a snapshot
+ * (see @a StateReader and @a current) tell whether it is still current
+ * without any lock.
+ */
+template <class S>
+class ReduCxx::_impl::SnapshotCell {
+public:
+    explicit SnapshotCell(std::shared_ptr<const S> snapshot) : m_id(nextId()), m_snapshot(std::move(snapshot)) { }
+
+    //! Steal the snapshot of @a temp, which must not be in use anymore
+    SnapshotCell(SnapshotCell&& temp) noexcept
+        : m_id(temp.m_id)
+        , m_snapshot(std::move(temp.m_snapshot))
+        , m_generation(temp.m_generation.load(std::memory_order_relaxed))
+    { }
+
+    SnapshotCell(const SnapshotCell&) = delete;
+    SnapshotCell& operator =(const SnapshotCell&) = delete;
+
+    //! Replace the current snapshot, the previous one lives as long as somebody holds it
+    void publish(std::shared_ptr<const S> snapshot) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_snapshot.swap(snapshot);
+            m_generation.fetch_add(1, std::memory_order_release);
+        }
+        // the previous snapshot, if last, is destroyed out of the lock
+    }
+
+    //! Load the current snapshot and its generation consistently
+    std::shared_ptr<const S> load(std::uint64_t& generation) const {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        generation = m_generation.load(std::memory_order_relaxed);
+        return m_snapshot;
+    }
+
+    std::uint64_t generation() const { return m_generation.load(std::memory_order_acquire); }
+
+    /**
+     * Current snapshot as cached by the calling thread, loaded again only
+     * once a new one is published: threads reading the same cell share no
+     * lock and no reference count. The reference is valid until the next
+     * call by the same thread, the cache holding the last snapshot a thread
+     * read (of any cell of @a S) until then.
+     */
+    const std::shared_ptr<const S>& current() const {
+        struct Cache {
+            std::uint64_t cell = 0;
+            std::uint64_t generation = 0;
+            std::shared_ptr<const S> snapshot;
+        };
+        thread_local Cache cache;
+        if (cache.cell != m_id || cache.generation != generation()) {
+            cache.snapshot = load(cache.generation);
+            cache.cell = m_id;
+        }
+        return cache.snapshot;
+    }
+
+private:
+    const std::uint64_t m_id;   // unique, unlike addresses which cells reuse
+    mutable std::mutex m_mutex;
+    std::shared_ptr<const S> m_snapshot;
+    std::atomic<std::uint64_t> m_generation { 0 };
+
+    static std::uint64_t nextId() {
+        static std::atomic<std::uint64_t> cells { 0 };
+        return cells.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+};
+
+/**
+ * @brief Per-thread reader of the state of an AsyncStore, see
+ * @a AsyncStore::reader.
+ * It caches the last snapshot it got: as long as no new state is published,
+ * reading costs a single atomic load of a counter shared by all the readers
+ * but written by the reducers thread only, so reads by different threads do
+ * not contend with each other.
+ * @warning A reader is not thread-safe (use one per thread) and shall not
+ * outlive its Store.
+ */
+template <class S>
+class ReduCxx::StateReader {
+public:
+    explicit StateReader(const _impl::SnapshotCell<S>& cell)
+        : m_cell(&cell)
+        , m_snapshot(cell.load(m_generation))
+    { }
+
+    //! @brief Return the current state, valid until the next call
+    const S& state() {
+        if (m_cell->generation() != m_generation) {
+            m_snapshot = m_cell->load(m_generation);
+        }
+        return *m_snapshot;
+    }
+
+    //! @brief Return a handle to the current state, valid as long as held
+    const std::shared_ptr<const S>& snapshot() {
+        state();
+        return m_snapshot;
+    }
+
+private:
+    const _impl::SnapshotCell<S>* m_cell;
+    std::uint64_t m_generation = 0;
+    std::shared_ptr<const S> m_snapshot;
+};
+
+#endif //REDUCXX_STATE_READER_HPP
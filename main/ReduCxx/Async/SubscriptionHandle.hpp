@@ -3,14 +3,56 @@
 
 #include <future>
 #include <queue>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <list>
+#include <mutex>
+#include <vector>
 
 namespace ReduCxx {
+    class TrackingPolicy;
+
     class SubscriptionHandle;
 }
 
+/**
+ * @brief Describe how a SubscriptionHandle tracks the executions of an
+ * asynchronous subscription.
+ */
+class ReduCxx::TrackingPolicy {
+public:
+
+    //! Keep the future of every execution until waited for: memory grows until then
+    static TrackingPolicy futures() { return TrackingPolicy(false, 0); }
+
+    /**
+     * @brief Only count the executions, keeping the exceptions of the last
+     * @a errors failed ones: memory stays bounded and no future is allocated,
+     * so that long-lived subscriptions can ignore their handle.
+     */
+    static TrackingPolicy counters(std::size_t errors = 16) { return TrackingPolicy(true, errors); }
+
+    [[nodiscard]] bool isCounting() const { return m_counting; }
+    [[nodiscard]] std::size_t errorCapacity() const { return m_errors; }
+
+private:
+    TrackingPolicy(bool counting, std::size_t errors) : m_counting(counting), m_errors(errors) { }
+
+    bool m_counting;
+    std::size_t m_errors;
+};
+
 /**
  * @brief Collect results of an asynchronous subscribed routine.
+ *
+ * By default each result is a future, waiting for it rethrows the exception
+ * of its execution. With a counting TrackingPolicy the handle only keeps
+ * counters and a bounded ring of the last exceptions: waits never rethrow,
+ * failures are read through @a failed() and @a takeErrors().
  */
 class ReduCxx::SubscriptionHandle {
 public:
@@ -20,9 +62,44 @@ public:
 
     SubscriptionHandle() = default;
 
+    explicit SubscriptionHandle(const TrackingPolicy& tracking)
+        : m_counting(tracking.isCounting())
+        , m_errors(tracking.isCounting() ? tracking.errorCapacity() : 0)
+    { }
+
+    //! Whether only counters are kept, see @a TrackingPolicy::counters
+    [[nodiscard]] bool isCounting() const { return m_counting; }
+
     inline void add(std::future<void>&& result) {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        m_futures.push_back(std::move(result));
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_futures.push_back(std::move(result));
+        }
+        m_waiter.notify_all();
+    }
+
+    //! Counting mode: an execution was posted
+    inline void expect() {
+        m_posted.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    //! Counting mode: an execution expected before completed, with @a error if it threw
+    inline void done(std::exception_ptr error = nullptr) {
+        if (error) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (!m_errors.empty()) {
+                m_errors[m_failed % m_errors.size()] = std::move(error);
+            }
+            ++m_failed;
+        }
+        m_completed.fetch_add(1);
+        // seq_cst against a waiter: either it sees the completion or we see it waiting
+        if (m_waiters.load() > 0) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+            }
+            m_waiter.notify_all();
+        }
     }
 
     /**
@@ -30,14 +107,48 @@ public:
      */
     inline int count() const {
         std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_counting) {
+            return static_cast<int>(m_posted.load() - m_waited);
+        }
         return m_futures.size();
     }
 
+    //! Counting mode: number of executions completed so far
+    inline std::uint64_t completed() const {
+        return m_completed.load();
+    }
+
+    //! Counting mode: number of executions that threw so far
+    inline std::uint64_t failed() const {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_failed;
+    }
+
+    /**
+     * @brief Counting mode: return the exceptions kept since the last call,
+     * oldest first; only the last ones are kept, see @a TrackingPolicy.
+     */
+    inline std::vector<std::exception_ptr> takeErrors() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        std::vector<std::exception_ptr> errors;
+        const std::uint64_t kept = std::min<std::uint64_t>(m_failed - m_taken, m_errors.size());
+        for (std::uint64_t i = m_failed - kept; i < m_failed; ++i) {
+            errors.push_back(std::move(m_errors[i % m_errors.size()]));
+        }
+        m_taken = m_failed;
+        return errors;
+    }
+
     /**
      * @brief Wait the for the first result to be ready, blocks if no result available.
      */
     inline void waitOne() {
         std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_counting) {
+            waitCompleted(lock, m_waited + 1);
+            ++m_waited;
+            return;
+        }
         m_waiter.wait(lock, [&]() { return !m_futures.empty(); });
         pop();
     }
@@ -52,6 +163,12 @@ public:
      */
     inline void waitAll() {
         std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_counting) {
+            const std::uint64_t target = m_posted.load();
+            waitCompleted(lock, target);
+            m_waited = std::max(m_waited, target);
+            return;
+        }
         while (!m_futures.empty()) {
             pop();
         }
@@ -61,20 +178,50 @@ public:
     bool waitAll(const std::chrono::duration<Rep,Period>& timeout);
 
 private:
+    const bool m_counting = false;
     mutable std::mutex m_mutex;
     std::condition_variable m_waiter;
     std::list<std::future<void>> m_futures;
 
+    // counting mode
+    std::atomic<std::uint64_t> m_posted { 0 };
+    std::atomic<std::uint64_t> m_completed { 0 };
+    std::atomic<int> m_waiters { 0 };
+    std::uint64_t m_waited = 0;                 // guarded by m_mutex, as the fields below
+    std::uint64_t m_failed = 0;
+    std::uint64_t m_taken = 0;                  // failures already returned by takeErrors
+    std::vector<std::exception_ptr> m_errors;   // ring of the last exceptions
+
     inline void pop() {
         std::future<void> one(std::move(*this->m_futures.begin()));
         this->m_futures.pop_front();
         one.get();
     }
+
+    inline void waitCompleted(std::unique_lock<std::mutex>& lock, std::uint64_t target) {
+        ++m_waiters;
+        m_waiter.wait(lock, [&]() { return m_completed.load() >= target; });
+        --m_waiters;
+    }
+
+    template <class Rep, class Period>
+    bool waitCompleted(std::unique_lock<std::mutex>& lock, std::uint64_t target,
+                       const std::chrono::duration<Rep,Period>& timeout) {
+        ++m_waiters;
+        const bool reached = m_waiter.wait_for(lock, timeout, [&]() { return m_completed.load() >= target; });
+        --m_waiters;
+        return reached;
+    }
 };
 
 template<class Rep, class Period>
 bool ReduCxx::SubscriptionHandle::waitOne(const std::chrono::duration<Rep, Period>& timeout) {
     std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_counting) {
+        if (!waitCompleted(lock, m_waited + 1, timeout)) return false;
+        ++m_waited;
+        return true;
+    }
     m_waiter.wait(lock, [&]() { return !m_futures.empty(); });
     if (m_futures.begin()->wait_for(timeout) != std::future_status::ready) return false;
     pop();
@@ -84,6 +231,12 @@ bool ReduCxx::SubscriptionHandle::waitOne(const std::chrono::duration<Rep, Perio
 template<class Rep, class Period>
 bool ReduCxx::SubscriptionHandle::waitAll(const std::chrono::duration<Rep, Period>& timeout) {
     std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_counting) {
+        const std::uint64_t target = m_posted.load();
+        if (!waitCompleted(lock, target, timeout)) return false;
+        m_waited = std::max(m_waited, target);
+        return true;
+    }
     while (!m_futures.empty()) {
         if (m_futures.begin()->wait_for(timeout) != std::future_status::ready) return false;
         pop();
@@ -0,0 +1,342 @@
+#ifndef REDUCXX_THREAD_POOL_HPP
+#define REDUCXX_THREAD_POOL_HPP
+
+#include "MpscQueue.hpp"
+#include "NodePool.hpp"
+#include "ReduCxx/InplaceFunction.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ReduCxx
+{
+    class ThreadPool;
+
+    class Strand;
+}
+
+/**
+ * @brief Fixed set of worker threads running tasks with work stealing.
+ * Each worker has its own deque, run in order: tasks submitted by a worker go
+ * to its own deque, other tasks are spread round robin; an idle worker steals
+ * the newest tasks of the others before parking.
+ * Tasks run concurrently and in no particular order, use a @a Strand to run
+ * a sequence of tasks one at a time and in order.
+ * The destructor runs the tasks still queued, then joins the workers.
+ */
+class ReduCxx::ThreadPool
+{
+  public:
+    typedef _impl::InplaceFunction<void(), 56> task;
+    typedef std::function<void(std::exception_ptr)> error_sink;
+
+    explicit ThreadPool(std::size_t threads = std::max(1u, std::thread::hardware_concurrency()));
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool();
+
+    //! Number of worker threads
+    std::size_t size() const { return m_workers.size(); }
+
+    /**
+     * @brief Run @a operation on any worker; its exceptions are passed to
+     * the error sink.
+     */
+    void execute(task&& operation);
+
+    /**
+     * @brief Set the function receiving the exceptions thrown by tasks; it
+     * runs on the worker threads and shall not throw. Without a sink those
+     * exceptions are discarded.
+     */
+    void setErrorSink(error_sink sink);
+
+  private:
+    friend class Strand;
+
+    struct Worker
+    {
+        std::mutex mutex;   // owner pops the front, thieves the back
+        std::deque<task> tasks;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<std::size_t> m_next { 0 };      // round robin of external submissions
+    std::atomic<std::size_t> m_queued { 0 };
+    std::atomic<std::size_t> m_parked { 0 };
+    std::mutex m_mutex;                         // parking and error sink
+    std::condition_variable m_available;
+    bool m_quit = false;
+    error_sink m_error_sink;
+
+    //! Pool and index of the calling worker thread, if any
+    static std::pair<const ThreadPool*, std::size_t>& worker()
+    {
+        static thread_local std::pair<const ThreadPool*, std::size_t> t_worker { nullptr, 0 };
+        return t_worker;
+    }
+
+    //! Index of the calling worker in this pool, or size() if not a worker
+    std::size_t self() const;
+
+    //! Pass @a error to the error sink, if any
+    void fail(std::exception_ptr error);
+
+    bool take(std::size_t index, task& operation);
+
+    void run(std::size_t index);
+};
+
+/**
+ * @brief Serial executor on top of a ThreadPool: the operations posted to a
+ * strand run one at a time, in posting order, on any of the pool workers.
+ * Strands are cheap, so that many independent sequences (as the async
+ * subscriptions of an AsyncStore) can share a pool sized to the cores.
+ * @warning The pool shall outlive the strand and its pending operations.
+ */
+class ReduCxx::Strand
+{
+  public:
+    explicit Strand(ThreadPool& pool) : m_pool(&pool), m_state(std::make_shared<State>()) { }
+
+    /**
+     * @brief Post given @a operation, returning a @a future to check for
+     * completion (and its exceptions).
+     */
+    template <class F>
+    std::future<void> post(F&& operation);
+
+    /**
+     * @brief Post given @a operation without any promise/future pair: its
+     * exceptions are passed to the error sink of the pool.
+     */
+    template <class F>
+    void postDetached(F&& operation) { enqueue(ThreadPool::task(std::forward<F>(operation))); }
+
+  private:
+    //! Operations run at most on a pool task, before yielding the worker to other tasks
+    static constexpr std::size_t BATCH = 64;
+
+    struct State
+    {
+        _impl::MpscQueue<ThreadPool::task> queue;
+        std::atomic<std::size_t> pending { 0 };     // a drain task is scheduled while not zero
+    };
+
+    ThreadPool* m_pool;
+    std::shared_ptr<State> m_state;     // shared with the scheduled drain task
+
+    void enqueue(ThreadPool::task&& operation);
+
+    static void drain(ThreadPool* pool, const std::shared_ptr<State>& state);
+};
+
+inline ReduCxx::ThreadPool::ThreadPool(std::size_t threads)
+{
+    m_workers.reserve(threads > 0 ? threads : 1);
+    for (std::size_t i = 0; i < std::max<std::size_t>(threads, 1); ++i)
+    {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    // started once all the deques exist, since workers steal from each other
+    for (std::size_t i = 0; i < m_workers.size(); ++i)
+    {
+        m_workers[i]->thread = std::thread(&ThreadPool::run, this, i);
+    }
+}
+
+inline ReduCxx::ThreadPool::~ThreadPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_available.notify_all();
+    for (const std::unique_ptr<Worker>& worker : m_workers)
+    {
+        worker->thread.join();
+    }
+}
+
+inline void ReduCxx::ThreadPool::execute(task&& operation)
+{
+    std::size_t index = self();
+    if (index == m_workers.size())
+    {
+        index = m_next.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+    }
+    {
+        std::unique_lock<std::mutex> lock(m_workers[index]->mutex);
+        m_workers[index]->tasks.push_back(std::move(operation));
+    }
+    // seq_cst against a worker parking: either it sees the task or we see it parked
+    m_queued.fetch_add(1);
+    if (m_parked.load() > 0)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+        }
+        m_available.notify_one();
+    }
+}
+
+inline void ReduCxx::ThreadPool::setErrorSink(error_sink sink)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_error_sink = std::move(sink);
+}
+
+inline std::size_t ReduCxx::ThreadPool::self() const
+{
+    return worker().first == this ? worker().second : m_workers.size();
+}
+
+inline void ReduCxx::ThreadPool::fail(std::exception_ptr error)
+{
+    error_sink sink;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        sink = m_error_sink;
+    }
+    if (sink)
+    {
+        sink(std::move(error));
+    }
+}
+
+inline bool ReduCxx::ThreadPool::take(std::size_t index, task& operation)
+{
+    {
+        Worker& own = *m_workers[index];
+        std::unique_lock<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty())
+        {
+            operation = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+    for (std::size_t i = 1; i < m_workers.size(); ++i)
+    {
+        Worker& victim = *m_workers[(index + i) % m_workers.size()];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (lock && !victim.tasks.empty())
+        {
+            operation = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void ReduCxx::ThreadPool::run(std::size_t index)
+{
+    worker() = { this, index };
+    for (;;)
+    {
+        task operation;
+        if (take(index, operation))
+        {
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            try
+            {
+                operation();
+            }
+            catch (...)
+            {
+                fail(std::current_exception());
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_queued.load() > 0)
+        {
+            continue;   // queued in a deque we could not lock, or being pushed
+        }
+        if (m_quit)
+        {
+            return;
+        }
+        m_parked.fetch_add(1);
+        m_available.wait(lock, [&]() { return m_quit || m_queued.load() > 0; });
+        m_parked.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+template <class F>
+std::future<void> ReduCxx::Strand::post(F&& operation)
+{
+    std::promise<void> promise;
+    std::future<void> result = promise.get_future();
+    enqueue([operation = std::forward<F>(operation), promise = std::move(promise)]() mutable {
+        try
+        {
+            operation();
+            promise.set_value();
+        }
+        catch (...)
+        {
+            promise.set_exception(std::current_exception());
+        }
+    });
+    return result;
+}
+
+inline void ReduCxx::Strand::enqueue(ThreadPool::task&& operation)
+{
+    m_state->queue.push(std::move(operation));
+    if (m_state->pending.fetch_add(1, std::memory_order_acq_rel) == 0)
+    {
+        m_pool->execute([pool = m_pool, state = m_state]() { drain(pool, state); });
+    }
+}
+
+/**
+ * Run the queued operations of @a state until none is left, or reschedule
+ * after a batch so that busy strands do not starve the other tasks.
+ * Only one drain task per strand is scheduled at a time.
+ */
+inline void ReduCxx::Strand::drain(ThreadPool* pool, const std::shared_ptr<State>& state)
+{
+    for (std::size_t done = 0;; )
+    {
+        std::optional<ThreadPool::task> operation = state->queue.pop();
+        if (!operation)
+        {
+            std::this_thread::yield();  // counted, but a producer is half-way through its push
+            continue;
+        }
+        try
+        {
+            (*operation)();
+        }
+        catch (...)
+        {
+            pool->fail(std::current_exception());
+        }
+        if (state->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            return;
+        }
+        if (++done == BATCH)
+        {
+            pool->execute([pool, state]() { drain(pool, state); });
+            return;
+        }
+    }
+}
+
+#endif //REDUCXX_THREAD_POOL_HPP
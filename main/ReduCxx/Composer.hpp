@@ -1,9 +1,16 @@
 #ifndef REDUCXX_COMPOSER_HPP
 #define REDUCXX_COMPOSER_HPP
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include "ReducerTraits.hpp"
+#include "Routing.hpp"
+#include "Shared.hpp"
 
 namespace ReduCxx
 {
@@ -12,6 +19,15 @@ namespace ReduCxx
 
     template <class A>
     struct Reduce;
+
+    //! One bit per sub-state of a composite state, set when it changed
+    using DirtyMask = std::uint64_t;
+
+    namespace _impl
+    {
+        template <class F>
+        class SharedReducer;
+    }
 } // namespace ReduCxx
 
 //! @internal
@@ -25,21 +41,225 @@ class ReduCxx::Composer
     Composer(const Reducers &... reducers)
         : m_reducers(reducers...) {}
 
-    CompositeState operator()(const CompositeState &state, const A &action)
+    CompositeState operator()(const CompositeState &state, const A &action) const
+    {
+        DirtyMask dirty;
+        return (*this)(state, action, dirty);
+    }
+
+    /**
+     * @brief Reduce consuming the previous @a state: sub-states are moved into
+     * reducers taking them by rvalue and updated in place by reducers taking
+     * them by reference, instead of being copied.
+     * @warning If a reducer throws, the sub-states of the reducers consuming
+     * them may be left partially reduced; the other ones are unchanged.
+     */
+    CompositeState operator()(CompositeState &&state, const A &action) const
+    {
+        DirtyMask dirty;
+        return (*this)(std::move(state), action, dirty);
+    }
+
+    /**
+     * @brief Reduce as above, also reporting in @a dirty which sub-states
+     * changed: bit I is set if reducer I was invoked (i.e. it was not routed
+     * away) and did not return std::nullopt.
+     */
+    CompositeState operator()(const CompositeState &state, const A &action, DirtyMask &dirty) const
+    {
+        if constexpr (ROUTED)
+        {
+            return route(CompositeState(state), action, dirty);
+        }
+        else
+        {
+            return apply(state, action, dirty, std::index_sequence_for<Reducers...>{});
+        }
+    }
+
+    CompositeState operator()(CompositeState &&state, const A &action, DirtyMask &dirty) const
+    {
+        if constexpr (ROUTED)
+        {
+            return route(std::move(state), action, dirty);
+        }
+        else
+        {
+            return apply(std::move(state), action, dirty, std::index_sequence_for<Reducers...>{});
+        }
+    }
+
+    template <std::size_t... Is>
+    CompositeState apply(const CompositeState &state, const A &action, std::index_sequence<Is...> is) const
+    {
+        DirtyMask dirty;
+        return apply(state, action, dirty, is);
+    }
+
+    template <std::size_t... Is>
+    CompositeState apply(CompositeState &&state, const A &action, std::index_sequence<Is...> is) const
+    {
+        DirtyMask dirty;
+        return apply(std::move(state), action, dirty, is);
+    }
+
+    template <std::size_t... Is>
+    CompositeState apply(const CompositeState &state, const A &action, DirtyMask &dirty, std::index_sequence<Is...>) const
     {
-        return apply(state, action, std::index_sequence_for<Reducers...>{});
+        std::array<bool, sizeof...(Is)> changed{(static_cast<void>(Is), true)...};
+        CompositeState next{_impl::reduce(std::get<Is>(m_reducers), std::get<Is>(state), action, &changed[Is])...};
+        dirty = (DirtyMask(0) | ... | (DirtyMask(changed[Is]) << Is));
+        return next;
     }
 
     template <std::size_t... Is>
-    CompositeState apply(const CompositeState &state, const A &action, std::index_sequence<Is...>)
+    CompositeState apply(CompositeState &&state, const A &action, DirtyMask &dirty, std::index_sequence<Is...>) const
     {
-        return {std::get<Is>(m_reducers)(std::get<Is>(state), action)...};
+        std::array<bool, sizeof...(Is)> changed{(static_cast<void>(Is), true)...};
+        CompositeState next{_impl::reduce(std::get<Is>(m_reducers), std::get<Is>(std::move(state)), action, &changed[Is])...};
+        dirty = (DirtyMask(0) | ... | (DirtyMask(changed[Is]) << Is));
+        return next;
     }
 
   private:
+    template <std::size_t I>
+    using Route = _impl::RouteTraits<std::tuple_element_t<I, ReducersTuple>>;
+
+    static_assert(sizeof...(Reducers) <= 8 * sizeof(DirtyMask), "too many reducers to track their changes");
+
+    //! true if at least one reducer declares the action types it handles
+    static constexpr bool ROUTED = (_impl::RouteTraits<std::decay_t<Reducers>>::Routed || ...);
+
+    using RouteTypes = typename _impl::ConcatTypes<typename _impl::RouteTraits<std::decay_t<Reducers>>::Types_t...>::type;
+    typedef CompositeState (Composer::*route_t)(CompositeState &&, const A &, DirtyMask &) const;
+
     const ReducersTuple m_reducers;
+
+    //! Look up the reducers interested in @a action in the table generated at compile time
+    CompositeState route(CompositeState &&state, const A &action, DirtyMask &dirty) const
+    {
+        static constexpr auto routes = makeRoutes(RouteTypes{});
+        const int type = action.type();
+        dirty = 0;
+        if (type >= routes.first && type - routes.first < static_cast<int>(routes.second.size()))
+        {
+            return (this->*routes.second[type - routes.first])(std::move(state), action, dirty);
+        }
+        return applyRoute<false, 0>(std::move(state), action, dirty);
+    }
+
+    /**
+     * Build a table indexed by action type (offset by the smallest declared
+     * one) pointing to the specialization of @a applyRoute for that type.
+     */
+    template <int... Types>
+    static constexpr auto makeRoutes(std::integer_sequence<int, Types...>)
+    {
+        constexpr int first = std::min({Types...});
+        constexpr int last = std::max({Types...});
+        static_assert(last - first < 4096, "action types handled by reducers are too sparse for a routing table");
+        std::array<route_t, last - first + 1> table{};
+        for (auto &entry : table)
+        {
+            entry = &Composer::applyRoute<false, 0>;
+        }
+        ((table[Types - first] = &Composer::applyRoute<true, Types>), ...);
+        return std::make_pair(first, table);
+    }
+
+    //! Invoke only the reducers handling @a Type (or any type), the other
+    //! sub-states of @a next are left as they are
+    template <bool Known, int Type>
+    CompositeState applyRoute(CompositeState &&next, const A &action, DirtyMask &dirty) const
+    {
+        return applyRoute<Known, Type>(std::move(next), action, dirty, std::index_sequence_for<Reducers...>{});
+    }
+
+    //! Every invoked reducer returns before any sub-state of @a next is
+    //! overwritten, so that one throwing leaves the sub-states of the others
+    //! as they were (unless they consume them)
+    template <bool Known, int Type, std::size_t... Is>
+    CompositeState applyRoute(CompositeState &&next, const A &action, DirtyMask &dirty, std::index_sequence<Is...>) const
+    {
+        std::tuple<std::optional<std::tuple_element_t<Is, CompositeState>>...> reduced{
+            reduceIf<Is, Route<Is>::handles(Type) && (Known || !Route<Is>::Routed)>(next, action, dirty)...};
+        (storeIf<Is>(next, std::get<Is>(reduced)), ...);
+        return std::move(next);
+    }
+
+    template <std::size_t I, bool Invoke>
+    std::optional<std::tuple_element_t<I, CompositeState>> reduceIf(CompositeState &next, const A &action, DirtyMask &dirty) const
+    {
+        if constexpr (Invoke)
+        {
+            bool changed = true;
+            std::optional<std::tuple_element_t<I, CompositeState>> reduced(
+                _impl::reduce(std::get<I>(m_reducers), std::move(std::get<I>(next)), action, &changed));
+            dirty |= DirtyMask(changed) << I;
+            return reduced;
+        }
+        else
+        {
+            return std::nullopt;
+        }
+    }
+
+    template <std::size_t I>
+    static void storeIf(CompositeState &next, std::optional<std::tuple_element_t<I, CompositeState>> &reduced)
+    {
+        if (reduced)
+        {
+            std::get<I>(next) = std::move(*reduced);
+        }
+    }
+};
+
+//! @internal a Composer can be used as a reducer itself
+template <class A, class... Reducers>
+struct ReduCxx::_impl::ReducerTraits<ReduCxx::Composer<A, Reducers...>>
+    : ReducerTraits<typename ReduCxx::Composer<A, Reducers...>::CompositeState(
+          const typename ReduCxx::Composer<A, Reducers...>::CompositeState &, const A &)>
+{};
+
+/**
+ * @internal
+ * @brief Adapt a reducer of @a T to work on a @a Shared<T> sub-state.
+ * If the reducer returns an empty std::optional the input box is returned as
+ * is, so the sub-state is neither copied nor reallocated.
+ */
+template <class F>
+class ReduCxx::_impl::SharedReducer
+{
+    using Traits = ReducerTraits<F>;
+    using State = typename Traits::State_t;
+    using Action = typename Traits::Action_t;
+
+  public:
+    explicit SharedReducer(const F& reducer) : m_reducer(reducer) {}
+
+    //! An unchanged sub-state is propagated as std::nullopt, so that the caller
+    //! keeps the input box and knows it is unchanged
+    auto operator()(const Shared<State> &state, const Action &action) const
+    {
+        if constexpr (Traits::MayBeUnchanged)
+        {
+            std::optional<State> next = m_reducer(*state, action);
+            return next ? std::optional<Shared<State>>(std::move(*next)) : std::nullopt;
+        }
+        else
+        {
+            return Shared<State>(_impl::reduce(m_reducer, *state, action));
+        }
+    }
+
+  private:
+    F m_reducer;
 };
 
+//! @internal shared sub-states are routed as the reducer they wrap
+template <class F>
+struct ReduCxx::_impl::RouteTraits<ReduCxx::_impl::SharedReducer<F>, void> : RouteTraits<F> {};
+
 template <class A>
 struct ReduCxx::Reduce
 {
@@ -48,6 +268,18 @@ struct ReduCxx::Reduce
     {
         return Composer<A, Reducers...>(reducers...);
     }
+
+    /**
+     * @brief Compose given reducers into a state made of @a Shared boxes,
+     * i.e. std::tuple<Shared<State1>, Shared<State2>, ...>.
+     * Reducers may return a std::optional of their state, and std::nullopt to
+     * signal the state is unchanged: in that case the very same box is kept.
+     */
+    template <class... Reducers>
+    static inline Composer<A, _impl::SharedReducer<Reducers>...> shared(Reducers... reducers)
+    {
+        return Composer<A, _impl::SharedReducer<Reducers>...>(_impl::SharedReducer<Reducers>(reducers)...);
+    }
 };
 
 #endif //REDUCXX_COMPOSER_HPP
@@ -0,0 +1,281 @@
+#ifndef REDUCXX_HISTORY_HPP
+#define REDUCXX_HISTORY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace ReduCxx
+{
+    class HistoryPolicy;
+
+    namespace _impl
+    {
+        template <class S>
+        class History;
+
+        template <class S, class A>
+        class ActionLog;
+    }
+} // namespace ReduCxx
+
+/**
+ * @brief Describe how many states a Store retains to support @a revert().
+ * The depth counts the current state too, so both 0 and 1 mean "no undo".
+ *
+ * States are either kept as full copies or, when event-sourced, rebuilt on
+ * revert by replaying the dispatched actions from the closest snapshot.
+ */
+class ReduCxx::HistoryPolicy
+{
+  public:
+    static constexpr std::size_t UNBOUNDED = std::numeric_limits<std::size_t>::max();
+
+    //! Retain every state ever reached (grows without limit)
+    static HistoryPolicy unbounded() { return HistoryPolicy(UNBOUNDED, 0); }
+
+    //! Retain at most @a depth states, oldest ones are overwritten first
+    static HistoryPolicy bounded(std::size_t depth) { return HistoryPolicy(depth > 0 ? depth : 1, 0); }
+
+    /**
+     * @brief Retain the dispatched actions plus a copy of the state every
+     * @a snapshotEvery actions instead of every state.
+     * A revert then costs up to @a snapshotEvery reducer calls.
+     * @note Requires copyable actions and deterministic reducers.
+     */
+    static HistoryPolicy eventSourced(std::size_t snapshotEvery, std::size_t depth = UNBOUNDED)
+    { return HistoryPolicy(depth > 0 ? depth : 1, snapshotEvery > 0 ? snapshotEvery : 1); }
+
+    [[nodiscard]] std::size_t depth() const { return m_depth; }
+    [[nodiscard]] bool isBounded() const { return m_depth != UNBOUNDED; }
+    [[nodiscard]] bool isEventSourced() const { return m_snapshotInterval != 0; }
+    [[nodiscard]] std::size_t snapshotInterval() const { return m_snapshotInterval; }
+
+  private:
+    HistoryPolicy(std::size_t depth, std::size_t snapshotInterval)
+        : m_depth(depth), m_snapshotInterval(snapshotInterval)
+    { }
+
+    std::size_t m_depth;
+    std::size_t m_snapshotInterval;
+};
+
+/**
+ * @internal
+ * @brief Ring of state slots, the newest one being the current state.
+ * When bounded all the slots are allocated upfront and recycled, otherwise the
+ * ring doubles its capacity when full.
+ */
+template <class S>
+class ReduCxx::_impl::History
+{
+  public:
+    explicit History(const HistoryPolicy& policy)
+        : m_slots(policy.isBounded() ? policy.depth() : INITIAL_CAPACITY)
+        , m_head(0)
+        , m_size(1)
+        , m_bounded(policy.isBounded())
+    { }
+
+    [[nodiscard]] const S& back() const { return m_slots[m_head]; }
+    S& back() { return m_slots[m_head]; }
+
+    //! Number of retained states, current one included
+    [[nodiscard]] std::size_t size() const { return m_size; }
+
+    void push(S&& state);
+
+    bool pop();
+
+  private:
+    static constexpr std::size_t INITIAL_CAPACITY = 16;
+
+    std::vector<S> m_slots;
+    std::size_t m_head;
+    std::size_t m_size;
+    bool m_bounded;
+
+    void grow();
+};
+
+/**
+ * @internal
+ * @brief Log of dispatched actions plus periodic state snapshots, used by
+ * event-sourced histories to rebuild previous states on demand.
+ * The current state itself is not kept here.
+ */
+template <class S, class A>
+class ReduCxx::_impl::ActionLog
+{
+  public:
+    explicit ActionLog(const HistoryPolicy& policy)
+        : m_interval(policy.snapshotInterval())
+        , m_depth(policy.depth())
+        , m_step(0)
+        , m_floor(0)
+    {
+        m_snapshots.push_back({ 0, S() });
+    }
+
+    //! Record that @a action led to @a state
+    void record(const A& action, const S& state) { record(&action, &action + 1, state); }
+
+    //! Record that the actions in [@a first, @a last) led to @a state at once,
+    //! they will be reverted all together
+    template <class It>
+    void record(It first, It last, const S& state);
+
+    /**
+     * @brief Rebuild the state preceding the current one by replaying the
+     * actions through @a reducer, then forget the last action.
+     * @return the previous state or nothing if out of the retained window
+     */
+    template <class F>
+    std::optional<S> revert(const F& reducer);
+
+  private:
+    struct Snapshot
+    {
+        std::size_t step;
+        S state;
+    };
+
+    const std::size_t m_interval;
+    const std::size_t m_depth;
+    std::size_t m_step;
+    std::size_t m_floor; // first step that can still be reverted to
+    std::deque<Snapshot> m_snapshots;
+    std::deque<A> m_actions; // actions from step m_snapshots.front().step on
+    std::deque<std::size_t> m_sizes; // m_sizes[i] actions led to step m_snapshots.front().step + i + 1
+
+    void trim();
+};
+
+template <class S, class A>
+template <class It>
+void ReduCxx::_impl::ActionLog<S, A>::record(It first, It last, const S& state)
+{
+    const std::size_t size = m_actions.size();
+    m_actions.insert(m_actions.end(), first, last);
+    m_sizes.push_back(m_actions.size() - size);
+    ++m_step;
+    if (m_step % m_interval == 0)
+    {
+        m_snapshots.push_back({ m_step, state });
+    }
+    trim();
+}
+
+template <class S, class A>
+template <class F>
+std::optional<S> ReduCxx::_impl::ActionLog<S, A>::revert(const F& reducer)
+{
+    if (m_step <= m_floor)
+    {
+        return std::nullopt;
+    }
+    const std::size_t target = m_step - 1;
+    auto base = m_snapshots.end();
+    do
+    {
+        --base;
+    } while (base->step > target);
+
+    // locate the first action to replay walking back from the last one
+    const std::size_t first = m_snapshots.front().step;
+    std::size_t index = m_actions.size();
+    for (std::size_t step = m_step; step > base->step; --step)
+    {
+        index -= m_sizes[step - 1 - first];
+    }
+
+    // replay first: if the reducer throws nothing has changed
+    S state = base->state;
+    const std::size_t end = m_actions.size() - m_sizes.back();
+    for (; index < end; ++index)
+    {
+        state = reducer(state, m_actions[index]);
+    }
+
+    m_snapshots.erase(base + 1, m_snapshots.end());
+    m_actions.erase(m_actions.begin() + end, m_actions.end());
+    m_sizes.pop_back();
+    m_step = target;
+    return state;
+}
+
+template <class S, class A>
+void ReduCxx::_impl::ActionLog<S, A>::trim()
+{
+    if (m_depth == HistoryPolicy::UNBOUNDED || m_step < m_depth)
+    {
+        return;
+    }
+    m_floor = std::max(m_floor, m_step + 1 - m_depth);
+
+    // drop the snapshots (and their actions) no longer needed to reach m_floor
+    while (m_snapshots.size() > 1 && m_snapshots[1].step <= m_floor)
+    {
+        std::size_t actions = 0;
+        for (std::size_t step = m_snapshots[0].step; step < m_snapshots[1].step; ++step)
+        {
+            actions += m_sizes.front();
+            m_sizes.pop_front();
+        }
+        m_actions.erase(m_actions.begin(), m_actions.begin() + actions);
+        m_snapshots.pop_front();
+    }
+}
+
+template <class S>
+void ReduCxx::_impl::History<S>::push(S&& state)
+{
+    const bool full = m_size == m_slots.size();
+    if (full && !m_bounded)
+    {
+        grow();
+    }
+    if (++m_head == m_slots.size())
+    {
+        m_head = 0;
+    }
+    m_slots[m_head] = std::move(state); // when bounded and full, this overwrites the oldest state
+    if (!full || !m_bounded)
+    {
+        ++m_size;
+    }
+}
+
+template <class S>
+bool ReduCxx::_impl::History<S>::pop()
+{
+    if (m_size == 1)
+    {
+        return false;
+    }
+    // release whatever the reverted state was holding, its slot is left moved-from until overwritten
+    const S reverted(std::move(m_slots[m_head]));
+    m_head = (m_head == 0 ? m_slots.size() : m_head) - 1;
+    --m_size;
+    return true;
+}
+
+template <class S>
+void ReduCxx::_impl::History<S>::grow()
+{
+    const std::size_t capacity = m_slots.size();
+    std::vector<S> slots(capacity * 2);
+    std::size_t oldest = (m_head + capacity - m_size + 1) % capacity;
+    for (std::size_t i = 0; i < m_size; ++i)
+    {
+        slots[i] = std::move(m_slots[(oldest + i) % capacity]);
+    }
+    m_slots.swap(slots);
+    m_head = m_size - 1;
+}
+
+#endif //REDUCXX_HISTORY_HPP
@@ -0,0 +1,163 @@
+#ifndef REDUCXX_INPLACE_FUNCTION_HPP
+#define REDUCXX_INPLACE_FUNCTION_HPP
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ReduCxx
+{
+    namespace _impl
+    {
+        template <class Signature, std::size_t Capacity = 48>
+        class InplaceFunction;
+    }
+} // namespace ReduCxx
+
+/**
+ * @internal
+ * @brief Move-only std::function replacement storing callables of up to
+ * @a Capacity bytes within itself.
+ * Bigger callables, or ones that may throw when moved, are boxed on the heap
+ * once at construction: invoking never allocates.
+ */
+template <class R, class... Args, std::size_t Capacity>
+class ReduCxx::_impl::InplaceFunction<R(Args...), Capacity>
+{
+  public:
+    InplaceFunction() noexcept : m_ops(nullptr) { }
+
+    template <class F, class = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InplaceFunction>>>
+    InplaceFunction(F&& callable) // NOLINT: implicit as std::function
+        : m_ops(&OPS<std::decay_t<F>>)
+    {
+        using Fn = std::decay_t<F>;
+        if constexpr (Inline<Fn>)
+        {
+            new (&m_storage) Fn(std::forward<F>(callable));
+        }
+        else
+        {
+            new (&m_storage) Fn*(new Fn(std::forward<F>(callable)));
+        }
+    }
+
+    InplaceFunction(InplaceFunction&& temp) noexcept : m_ops(temp.m_ops)
+    {
+        if (m_ops)
+        {
+            m_ops->relocate(&m_storage, &temp.m_storage);
+            temp.m_ops = nullptr;
+        }
+    }
+
+    InplaceFunction& operator=(InplaceFunction&& temp) noexcept
+    {
+        if (this != &temp)
+        {
+            reset();
+            if (temp.m_ops)
+            {
+                temp.m_ops->relocate(&m_storage, &temp.m_storage);
+                m_ops = temp.m_ops;
+                temp.m_ops = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    InplaceFunction(const InplaceFunction&) = delete;
+    InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+    ~InplaceFunction() { reset(); }
+
+    explicit operator bool() const noexcept { return m_ops != nullptr; }
+
+    R operator()(Args... args) const
+    {
+        if (!m_ops)
+        {
+            throw std::bad_function_call();
+        }
+        return m_ops->invoke(&m_storage, std::forward<Args>(args)...);
+    }
+
+  private:
+    struct Ops
+    {
+        R (*invoke)(const void* storage, Args&&... args);
+        void (*relocate)(void* to, void* from) noexcept; // move-construct into to, destroy from
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    template <class Fn>
+    static constexpr bool Inline = sizeof(Fn) <= Capacity
+                                   && alignof(Fn) <= alignof(std::max_align_t)
+                                   && std::is_nothrow_move_constructible_v<Fn>;
+
+    template <class Fn>
+    static Fn& target(const void* storage)
+    {
+        if constexpr (Inline<Fn>)
+        {
+            return *std::launder(reinterpret_cast<Fn*>(const_cast<void*>(storage)));
+        }
+        else
+        {
+            return **std::launder(reinterpret_cast<Fn* const*>(storage));
+        }
+    }
+
+    template <class Fn>
+    static R invoke(const void* storage, Args&&... args)
+    {
+        return std::invoke(target<Fn>(storage), std::forward<Args>(args)...);
+    }
+
+    template <class Fn>
+    static void relocate(void* to, void* from) noexcept
+    {
+        if constexpr (Inline<Fn>)
+        {
+            Fn& source = target<Fn>(from);
+            new (to) Fn(std::move(source));
+            source.~Fn();
+        }
+        else
+        {
+            new (to) Fn*(&target<Fn>(from));
+        }
+    }
+
+    template <class Fn>
+    static void destroy(void* storage) noexcept
+    {
+        if constexpr (Inline<Fn>)
+        {
+            target<Fn>(storage).~Fn();
+        }
+        else
+        {
+            delete &target<Fn>(storage);
+        }
+    }
+
+    template <class Fn>
+    static constexpr Ops OPS { &invoke<Fn>, &relocate<Fn>, &destroy<Fn> };
+
+    void reset() noexcept
+    {
+        if (m_ops)
+        {
+            m_ops->destroy(&m_storage);
+            m_ops = nullptr;
+        }
+    }
+
+    const Ops* m_ops;
+    alignas(std::max_align_t) unsigned char m_storage[Capacity];
+};
+
+#endif //REDUCXX_INPLACE_FUNCTION_HPP
@@ -0,0 +1,455 @@
+#ifndef REDUCXX_PERSISTENT_MAP_HPP
+#define REDUCXX_PERSISTENT_MAP_HPP
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace ReduCxx
+{
+    template <class K, class V, class Hash = std::hash<K>, class KeyEqual = std::equal_to<K>>
+    class PersistentMap;
+}
+
+/**
+ * @brief Immutable unordered map with structural sharing, meant to be used
+ * inside states.
+ * Implemented as a hash array mapped trie: each node consumes 5 bits of the
+ * key hash and only stores the occupied slots. As for @a PersistentVector,
+ * every modifier returns a new map sharing all the untouched nodes with the
+ * original one, so a modified copy costs O(log32 n) node copies.
+ */
+template <class K, class V, class Hash, class KeyEqual>
+class ReduCxx::PersistentMap
+{
+    static constexpr unsigned BITS = 5;
+    static constexpr std::size_t MASK = (1u << BITS) - 1;
+    static constexpr unsigned HASH_BITS = sizeof(std::size_t) * 8;
+
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+    using Entry = std::pair<K, V>;
+    using Slot = std::variant<Entry, NodePtr>;
+
+    struct Node
+    {
+        std::uint32_t bitmap = 0;
+        std::vector<Slot> slots; // one per bit set in bitmap, or all colliding entries past HASH_BITS
+    };
+
+  public:
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef std::pair<K, V> value_type;
+    typedef std::size_t size_type;
+
+    class const_iterator;
+
+    PersistentMap() : m_size(0), m_root(emptyNode()) { }
+
+    PersistentMap(std::initializer_list<value_type> values);
+
+    [[nodiscard]] size_type size() const { return m_size; }
+    [[nodiscard]] bool empty() const { return m_size == 0; }
+
+    //! @return a pointer to the value mapped to @a key, nullptr if missing
+    const V* find(const K& key) const;
+
+    [[nodiscard]] bool contains(const K& key) const { return find(key) != nullptr; }
+
+    //! @throw std::out_of_range if @a key is missing
+    const V& at(const K& key) const;
+
+    //! @return a copy of this map with @a key mapped to @a value
+    [[nodiscard]] PersistentMap set(K key, V value) const;
+
+    //! @return a copy of this map without @a key (this map itself if missing)
+    [[nodiscard]] PersistentMap erase(const K& key) const;
+
+    //! @return a copy of this map with the value of @a key replaced by
+    //! @a op(value), or by @a op(V()) if missing
+    template <class F>
+    [[nodiscard]] PersistentMap update(const K& key, F&& op) const
+    {
+        const V* current = find(key);
+        return set(key, op(current ? *current : V()));
+    }
+
+    const_iterator begin() const { return const_iterator(m_root); }
+    const_iterator end() const { return const_iterator(); }
+
+    //! @return true when both maps share the same nodes (cheap identity check)
+    [[nodiscard]] bool identical(const PersistentMap& rhs) const { return m_root == rhs.m_root; }
+
+    bool operator==(const PersistentMap& rhs) const;
+    bool operator!=(const PersistentMap& rhs) const { return !(*this == rhs); }
+
+  private:
+    size_type m_size;
+    NodePtr m_root;
+
+    PersistentMap(size_type size, NodePtr root) : m_size(size), m_root(std::move(root)) { }
+
+    static const NodePtr& emptyNode()
+    {
+        static const NodePtr empty = std::make_shared<const Node>();
+        return empty;
+    }
+
+    static std::size_t hashOf(const K& key) { return Hash()(key); }
+
+    static std::uint32_t bitFor(std::size_t hash, unsigned shift)
+    { return std::uint32_t(1) << ((hash >> shift) & MASK); }
+
+    static std::size_t indexOf(std::uint32_t bitmap, std::uint32_t bit)
+    { return std::bitset<32>(bitmap & (bit - 1)).count(); }
+
+    static NodePtr insert(const Node& node, unsigned shift, std::size_t hash, K&& key, V&& value, bool& added);
+    static NodePtr remove(const NodePtr& node, unsigned shift, std::size_t hash, const K& key);
+    static NodePtr merge(unsigned shift, Entry&& first, std::size_t firstHash, Entry&& second, std::size_t secondHash);
+};
+
+/**
+ * @brief Forward iterator over the (key, value) pairs, in no particular order.
+ */
+template <class K, class V, class Hash, class KeyEqual>
+class ReduCxx::PersistentMap<K, V, Hash, KeyEqual>::const_iterator
+{
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef std::pair<K, V> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const value_type* pointer;
+    typedef const value_type& reference;
+
+    const_iterator() = default;
+
+    reference operator*() const { return std::get<Entry>(current()); }
+    pointer operator->() const { return &std::get<Entry>(current()); }
+
+    const_iterator& operator++()
+    {
+        ++m_stack.back().second;
+        settle();
+        return *this;
+    }
+
+    const_iterator operator++(int) { const_iterator old = *this; ++*this; return old; }
+
+    bool operator==(const const_iterator& rhs) const
+    {
+        if (m_stack.empty() || rhs.m_stack.empty())
+        {
+            return m_stack.empty() == rhs.m_stack.empty();
+        }
+        return m_stack.back() == rhs.m_stack.back();
+    }
+    bool operator!=(const const_iterator& rhs) const { return !(*this == rhs); }
+
+  private:
+    friend class PersistentMap;
+
+    // path from the root to the current slot: (node, slot index)
+    std::vector<std::pair<const Node*, std::size_t>> m_stack;
+
+    explicit const_iterator(const NodePtr& root)
+    {
+        m_stack.emplace_back(root.get(), 0);
+        settle();
+    }
+
+    const Slot& current() const { return m_stack.back().first->slots[m_stack.back().second]; }
+
+    //! move forward until the top of the stack points to an entry (or the end)
+    void settle()
+    {
+        while (!m_stack.empty())
+        {
+            auto& [node, index] = m_stack.back();
+            if (index >= node->slots.size())
+            {
+                m_stack.pop_back();
+                if (!m_stack.empty())
+                {
+                    ++m_stack.back().second;
+                }
+            }
+            else if (auto child = std::get_if<NodePtr>(&node->slots[index]))
+            {
+                m_stack.emplace_back(child->get(), 0);
+            }
+            else
+            {
+                return;
+            }
+        }
+    }
+};
+
+template <class K, class V, class Hash, class KeyEqual>
+ReduCxx::PersistentMap<K, V, Hash, KeyEqual>::PersistentMap(std::initializer_list<value_type> values)
+    : PersistentMap()
+{
+    for (const value_type& value : values)
+    {
+        *this = set(value.first, value.second);
+    }
+}
+
+template <class K, class V, class Hash, class KeyEqual>
+const V* ReduCxx::PersistentMap<K, V, Hash, KeyEqual>::find(const K& key) const
+{
+    const std::size_t hash = hashOf(key);
+    const Node* node = m_root.get();
+    for (unsigned shift = 0;; shift += BITS)
+    {
+        if (shift >= HASH_BITS)
+        {
+            for (const Slot& slot : node->slots)
+            {
+                const Entry& entry = std::get<Entry>(slot);
+                if (KeyEqual()(entry.first, key))
+                {
+                    return &entry.second;
+                }
+            }
+            return nullptr;
+        }
+        const std::uint32_t bit = bitFor(hash, shift);
+        if ((node->bitmap & bit) == 0)
+        {
+            return nullptr;
+        }
+        const Slot& slot = node->slots[indexOf(node->bitmap, bit)];
+        if (auto entry = std::get_if<Entry>(&slot))
+        {
+            return KeyEqual()(entry->first, key) ? &entry->second : nullptr;
+        }
+        node = std::get<NodePtr>(slot).get();
+    }
+}
+
+template <class K, class V, class Hash, class KeyEqual>
+const V& ReduCxx::PersistentMap<K, V, Hash, KeyEqual>::at(const K& key) const
+{
+    const V* value = find(key);
+    if (value == nullptr)
+    {
+        throw std::out_of_range("PersistentMap key not found");
+    }
+    return *value;
+}
+
+template <class K, class V, class Hash, class KeyEqual>
+ReduCxx::PersistentMap<K, V, Hash, KeyEqual>
+ReduCxx::PersistentMap<K, V, Hash, KeyEqual>::set(K key, V value) const
+{
+    bool added = false;
+    const std::size_t hash = hashOf(key);
+    NodePtr root = insert(*m_root, 0, hash, std::move(key), std::move(value), added);
+    return PersistentMap(added ? m_size + 1 : m_size, std::move(root));
+}
+
+template <class K, class V, class Hash, class KeyEqual>
+ReduCxx::PersistentMap<K, V, Hash, KeyEqual>
+ReduCxx::PersistentMap<K, V, Hash, KeyEqual>::erase(const K& key) const
+{
+    NodePtr root = remove(m_root, 0, hashOf(key), key);
+    if (root == m_root)
+    {
+        return *this;
+    }
+    return PersistentMap(m_size - 1, root ? std::move(root) : emptyNode());
+}
+
+template <class K, class V, class Hash, class KeyEqual>
+bool ReduCxx::PersistentMap<K, V, Hash, KeyEqual>::operator==(const PersistentMap& rhs) const
+{
+    if (identical(rhs))
+    {
+        return true;
+    }
+    if (m_size != rhs.m_size)
+    {
+        return false;
+    }
+    for (const value_type& entry : *this)
+    {
+        const V* other = rhs.find(entry.first);
+        if (other == nullptr || !(*other == entry.second))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class K, class V, class Hash, class KeyEqual>
+typename ReduCxx::PersistentMap<K, V, Hash, KeyEqual>::NodePtr
+ReduCxx::PersistentMap<K, V, Hash, KeyEqual>::insert(
+    const Node& node, unsigned shift, std::size_t hash, K&& key, V&& value, bool& added)
+{
+    auto copy = std::make_shared<Node>(node);
+    if (shift >= HASH_BITS)
+    {
+        // full hash collision: linear bucket
+        for (Slot& slot : copy->slots)
+        {
+            Entry& entry = std::get<Entry>(slot);
+            if (KeyEqual()(entry.first, key))
+            {
+                entry.second = std::move(value);
+                return copy;
+            }
+        }
+        copy->slots.emplace_back(Entry(std::move(key), std::move(value)));
+        added = true;
+        return copy;
+    }
+
+    const std::uint32_t bit = bitFor(hash, shift);
+    const std::size_t index = indexOf(node.bitmap, bit);
+    if ((node.bitmap & bit) == 0)
+    {
+        copy->bitmap |= bit;
+        copy->slots.emplace(copy->slots.begin() + index, Entry(std::move(key), std::move(value)));
+        added = true;
+        return copy;
+    }
+
+    Slot& slot = copy->slots[index];
+    if (auto entry = std::get_if<Entry>(&slot))
+    {
+        if (KeyEqual()(entry->first, key))
+        {
+            entry->second = std::move(value);
+        }
+        else
+        {
+            const std::size_t otherHash = hashOf(entry->first);
+            slot = merge(shift + BITS, std::move(*entry), otherHash, Entry(std::move(key), std::move(value)), hash);
+            added = true;
+        }
+    }
+    else
+    {
+        const NodePtr& child = std::get<NodePtr>(slot);
+        slot = insert(*child, shift + BITS, hash, std::move(key), std::move(value), added);
+    }
+    return copy;
+}
+
+template <class K, class V, class Hash, class KeyEqual>
+typename ReduCxx::PersistentMap<K, V, Hash, KeyEqual>::NodePtr
+ReduCxx::PersistentMap<K, V, Hash, KeyEqual>::merge(
+    unsigned shift, Entry&& first, std::size_t firstHash, Entry&& second, std::size_t secondHash)
+{
+    auto node = std::make_shared<Node>();
+    if (shift >= HASH_BITS)
+    {
+        node->slots.emplace_back(std::move(first));
+        node->slots.emplace_back(std::move(second));
+        return node;
+    }
+    const std::uint32_t firstBit = bitFor(firstHash, shift);
+    const std::uint32_t secondBit = bitFor(secondHash, shift);
+    if (firstBit == secondBit)
+    {
+        node->bitmap = firstBit;
+        node->slots.emplace_back(merge(shift + BITS, std::move(first), firstHash, std::move(second), secondHash));
+    }
+    else
+    {
+        node->bitmap = firstBit | secondBit;
+        if (firstBit < secondBit)
+        {
+            node->slots.emplace_back(std::move(first));
+            node->slots.emplace_back(std::move(second));
+        }
+        else
+        {
+            node->slots.emplace_back(std::move(second));
+            node->slots.emplace_back(std::move(first));
+        }
+    }
+    return node;
+}
+
+template <class K, class V, class Hash, class KeyEqual>
+typename ReduCxx::PersistentMap<K, V, Hash, KeyEqual>::NodePtr
+ReduCxx::PersistentMap<K, V, Hash, KeyEqual>::remove(
+    const NodePtr& node, unsigned shift, std::size_t hash, const K& key)
+{
+    std::size_t index = 0;
+    std::uint32_t bit = 0;
+    if (shift >= HASH_BITS)
+    {
+        while (index < node->slots.size() && !KeyEqual()(std::get<Entry>(node->slots[index]).first, key))
+        {
+            ++index;
+        }
+        if (index == node->slots.size())
+        {
+            return node;
+        }
+    }
+    else
+    {
+        bit = bitFor(hash, shift);
+        if ((node->bitmap & bit) == 0)
+        {
+            return node;
+        }
+        index = indexOf(node->bitmap, bit);
+        const Slot& slot = node->slots[index];
+        if (auto entry = std::get_if<Entry>(&slot))
+        {
+            if (!KeyEqual()(entry->first, key))
+            {
+                return node;
+            }
+        }
+        else
+        {
+            const NodePtr& child = std::get<NodePtr>(slot);
+            NodePtr updated = remove(child, shift + BITS, hash, key);
+            if (updated == child)
+            {
+                return node;
+            }
+            if (updated)
+            {
+                auto copy = std::make_shared<Node>(*node);
+                // a child left with a single entry collapses into this node
+                if (updated->slots.size() == 1 && std::holds_alternative<Entry>(updated->slots[0]))
+                {
+                    copy->slots[index] = updated->slots[0];
+                }
+                else
+                {
+                    copy->slots[index] = std::move(updated);
+                }
+                return copy;
+            }
+        }
+    }
+
+    // drop the slot at index
+    if (node->slots.size() == 1)
+    {
+        return nullptr;
+    }
+    auto copy = std::make_shared<Node>(*node);
+    copy->bitmap &= ~bit;
+    copy->slots.erase(copy->slots.begin() + index);
+    return copy;
+}
+
+#endif //REDUCXX_PERSISTENT_MAP_HPP
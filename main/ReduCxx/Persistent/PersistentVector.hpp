@@ -0,0 +1,395 @@
+#ifndef REDUCXX_PERSISTENT_VECTOR_HPP
+#define REDUCXX_PERSISTENT_VECTOR_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace ReduCxx
+{
+    template <class T>
+    class PersistentVector;
+}
+
+/**
+ * @brief Immutable vector with structural sharing, meant to be used inside
+ * states.
+ * Elements are stored in the leaves of a 32-way trie (plus a trailing leaf,
+ * the "tail"): every modifier returns a new vector that shares all the
+ * untouched nodes with the original one, so copying is O(1) and a modified
+ * copy only costs the path from the root to the changed leaf. This way each
+ * state retained in a Store history only pays for what actually changed.
+ *
+ * Example of reducer:
+ * @code
+ * PersistentVector<int> reducer(const PersistentVector<int>& state, const Add& action)
+ * {
+ *     return state.push_back(action.value);
+ * }
+ * @endcode
+ */
+template <class T>
+class ReduCxx::PersistentVector
+{
+    static constexpr unsigned BITS = 5;
+    static constexpr std::size_t WIDTH = 1u << BITS;
+    static constexpr std::size_t MASK = WIDTH - 1;
+
+    struct Node
+    {
+        std::vector<std::shared_ptr<const Node>> children;
+        std::vector<T> values;
+    };
+    using NodePtr = std::shared_ptr<const Node>;
+
+  public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef const T& const_reference;
+
+    class const_iterator;
+
+    PersistentVector()
+        : m_size(0), m_shift(BITS), m_root(emptyNode()), m_tail(emptyNode())
+    { }
+
+    PersistentVector(std::initializer_list<T> values);
+
+    [[nodiscard]] size_type size() const { return m_size; }
+    [[nodiscard]] bool empty() const { return m_size == 0; }
+
+    //! @brief Unchecked access to the element at @a index
+    const T& operator[](size_type index) const { return leafFor(index).values[index & MASK]; }
+
+    //! @brief Checked access to the element at @a index
+    //! @throw std::out_of_range
+    const T& at(size_type index) const;
+
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return (*this)[m_size - 1]; }
+
+    //! @return a copy of this vector with @a value appended
+    [[nodiscard]] PersistentVector push_back(T value) const;
+
+    //! @return a copy of this vector without its last element
+    [[nodiscard]] PersistentVector pop_back() const;
+
+    //! @return a copy of this vector with the element at @a index replaced by @a value
+    //! @throw std::out_of_range
+    [[nodiscard]] PersistentVector set(size_type index, T value) const;
+
+    //! @return a copy of this vector with the element at @a index replaced by @a op(element)
+    //! @throw std::out_of_range
+    template <class F>
+    [[nodiscard]] PersistentVector update(size_type index, F&& op) const { return set(index, op(at(index))); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_size); }
+
+    //! @return true when both vectors share the same nodes (cheap identity check)
+    [[nodiscard]] bool identical(const PersistentVector& rhs) const
+    { return m_size == rhs.m_size && m_root == rhs.m_root && m_tail == rhs.m_tail; }
+
+    bool operator==(const PersistentVector& rhs) const;
+    bool operator!=(const PersistentVector& rhs) const { return !(*this == rhs); }
+
+  private:
+    size_type m_size;
+    unsigned m_shift;
+    NodePtr m_root;
+    NodePtr m_tail;
+
+    PersistentVector(size_type size, unsigned shift, NodePtr root, NodePtr tail)
+        : m_size(size), m_shift(shift), m_root(std::move(root)), m_tail(std::move(tail))
+    { }
+
+    static const NodePtr& emptyNode()
+    {
+        static const NodePtr empty = std::make_shared<const Node>();
+        return empty;
+    }
+
+    [[nodiscard]] size_type tailOffset() const { return m_size < WIDTH ? 0 : ((m_size - 1) >> BITS) << BITS; }
+
+    const Node& leafFor(size_type index) const;
+
+    NodePtr pushTail(unsigned level, const Node& parent, NodePtr tail) const;
+    NodePtr popTail(unsigned level, const Node& node) const;
+    static NodePtr newPath(unsigned level, NodePtr node);
+    static NodePtr assoc(unsigned level, const Node& node, size_type index, T&& value);
+};
+
+template <class T>
+class ReduCxx::PersistentVector<T>::const_iterator
+{
+  public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T* pointer;
+    typedef const T& reference;
+
+    const_iterator() : m_owner(nullptr), m_index(0) { }
+
+    reference operator*() const { return (*m_owner)[m_index]; }
+    pointer operator->() const { return &(*m_owner)[m_index]; }
+    reference operator[](difference_type n) const { return (*m_owner)[m_index + n]; }
+
+    const_iterator& operator++() { ++m_index; return *this; }
+    const_iterator operator++(int) { const_iterator old = *this; ++m_index; return old; }
+    const_iterator& operator--() { --m_index; return *this; }
+    const_iterator operator--(int) { const_iterator old = *this; --m_index; return old; }
+    const_iterator& operator+=(difference_type n) { m_index += n; return *this; }
+    const_iterator& operator-=(difference_type n) { m_index -= n; return *this; }
+    const_iterator operator+(difference_type n) const { return const_iterator(m_owner, m_index + n); }
+    const_iterator operator-(difference_type n) const { return const_iterator(m_owner, m_index - n); }
+    difference_type operator-(const const_iterator& rhs) const
+    { return static_cast<difference_type>(m_index) - static_cast<difference_type>(rhs.m_index); }
+
+    bool operator==(const const_iterator& rhs) const { return m_index == rhs.m_index; }
+    bool operator!=(const const_iterator& rhs) const { return m_index != rhs.m_index; }
+    bool operator<(const const_iterator& rhs) const { return m_index < rhs.m_index; }
+    bool operator>(const const_iterator& rhs) const { return m_index > rhs.m_index; }
+    bool operator<=(const const_iterator& rhs) const { return m_index <= rhs.m_index; }
+    bool operator>=(const const_iterator& rhs) const { return m_index >= rhs.m_index; }
+
+  private:
+    friend class PersistentVector<T>;
+
+    const_iterator(const PersistentVector<T>* owner, size_type index) : m_owner(owner), m_index(index) { }
+
+    const PersistentVector<T>* m_owner;
+    size_type m_index;
+};
+
+template <class T>
+ReduCxx::PersistentVector<T>::PersistentVector(std::initializer_list<T> values)
+    : PersistentVector()
+{
+    for (const T& value : values)
+    {
+        *this = push_back(value);
+    }
+}
+
+template <class T>
+const T& ReduCxx::PersistentVector<T>::at(size_type index) const
+{
+    if (index >= m_size)
+    {
+        throw std::out_of_range("PersistentVector index out of range");
+    }
+    return (*this)[index];
+}
+
+template <class T>
+const typename ReduCxx::PersistentVector<T>::Node&
+ReduCxx::PersistentVector<T>::leafFor(size_type index) const
+{
+    if (index >= tailOffset())
+    {
+        return *m_tail;
+    }
+    const Node* node = m_root.get();
+    for (unsigned level = m_shift; level > 0; level -= BITS)
+    {
+        node = node->children[(index >> level) & MASK].get();
+    }
+    return *node;
+}
+
+template <class T>
+ReduCxx::PersistentVector<T> ReduCxx::PersistentVector<T>::push_back(T value) const
+{
+    if (m_size - tailOffset() < WIDTH)
+    {
+        auto tail = std::make_shared<Node>();
+        tail->values.reserve(m_tail->values.size() + 1);
+        tail->values = m_tail->values;
+        tail->values.push_back(std::move(value));
+        return PersistentVector(m_size + 1, m_shift, m_root, std::move(tail));
+    }
+
+    // tail is full: move it into the trie and start a new one
+    NodePtr root;
+    unsigned shift = m_shift;
+    if ((m_size >> BITS) > (size_type(1) << m_shift))
+    {
+        auto grown = std::make_shared<Node>();
+        grown->children.push_back(m_root);
+        grown->children.push_back(newPath(m_shift, m_tail));
+        root = std::move(grown);
+        shift += BITS;
+    }
+    else
+    {
+        root = pushTail(m_shift, *m_root, m_tail);
+    }
+    auto tail = std::make_shared<Node>();
+    tail->values.push_back(std::move(value));
+    return PersistentVector(m_size + 1, shift, std::move(root), std::move(tail));
+}
+
+template <class T>
+ReduCxx::PersistentVector<T> ReduCxx::PersistentVector<T>::pop_back() const
+{
+    if (m_size <= 1)
+    {
+        return PersistentVector();
+    }
+    if (m_size - tailOffset() > 1)
+    {
+        auto tail = std::make_shared<Node>();
+        tail->values.assign(m_tail->values.begin(), m_tail->values.end() - 1);
+        return PersistentVector(m_size - 1, m_shift, m_root, std::move(tail));
+    }
+
+    // tail is going to be empty: promote the last leaf of the trie
+    NodePtr tail = std::make_shared<Node>(leafFor(m_size - 2));
+    NodePtr root = popTail(m_shift, *m_root);
+    unsigned shift = m_shift;
+    if (!root)
+    {
+        root = emptyNode();
+    }
+    if (shift > BITS && root->children.size() == 1)
+    {
+        root = root->children[0];
+        shift -= BITS;
+    }
+    return PersistentVector(m_size - 1, shift, std::move(root), std::move(tail));
+}
+
+template <class T>
+ReduCxx::PersistentVector<T> ReduCxx::PersistentVector<T>::set(size_type index, T value) const
+{
+    if (index >= m_size)
+    {
+        throw std::out_of_range("PersistentVector index out of range");
+    }
+    if (index >= tailOffset())
+    {
+        auto tail = std::make_shared<Node>(*m_tail);
+        tail->values[index & MASK] = std::move(value);
+        return PersistentVector(m_size, m_shift, m_root, std::move(tail));
+    }
+    return PersistentVector(m_size, m_shift, assoc(m_shift, *m_root, index, std::move(value)), m_tail);
+}
+
+template <class T>
+bool ReduCxx::PersistentVector<T>::operator==(const PersistentVector& rhs) const
+{
+    if (identical(rhs))
+    {
+        return true;
+    }
+    if (m_size != rhs.m_size)
+    {
+        return false;
+    }
+    for (size_type i = 0; i < m_size; ++i)
+    {
+        if (!((*this)[i] == rhs[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class T>
+typename ReduCxx::PersistentVector<T>::NodePtr
+ReduCxx::PersistentVector<T>::pushTail(unsigned level, const Node& parent, NodePtr tail) const
+{
+    auto node = std::make_shared<Node>(parent);
+    size_type index = ((m_size - 1) >> level) & MASK;
+    NodePtr child;
+    if (level == BITS)
+    {
+        child = std::move(tail);
+    }
+    else if (index < parent.children.size())
+    {
+        child = pushTail(level - BITS, *parent.children[index], std::move(tail));
+    }
+    else
+    {
+        child = newPath(level - BITS, std::move(tail));
+    }
+    if (index < node->children.size())
+    {
+        node->children[index] = std::move(child);
+    }
+    else
+    {
+        node->children.push_back(std::move(child));
+    }
+    return node;
+}
+
+template <class T>
+typename ReduCxx::PersistentVector<T>::NodePtr
+ReduCxx::PersistentVector<T>::popTail(unsigned level, const Node& node) const
+{
+    size_type index = ((m_size - 2) >> level) & MASK;
+    if (level > BITS)
+    {
+        NodePtr child = popTail(level - BITS, *node.children[index]);
+        if (!child && index == 0)
+        {
+            return nullptr;
+        }
+        auto copy = std::make_shared<Node>(node);
+        if (child)
+        {
+            copy->children[index] = std::move(child);
+        }
+        else
+        {
+            copy->children.pop_back();
+        }
+        return copy;
+    }
+    if (index == 0)
+    {
+        return nullptr;
+    }
+    auto copy = std::make_shared<Node>(node);
+    copy->children.pop_back();
+    return copy;
+}
+
+template <class T>
+typename ReduCxx::PersistentVector<T>::NodePtr
+ReduCxx::PersistentVector<T>::newPath(unsigned level, NodePtr node)
+{
+    if (level == 0)
+    {
+        return node;
+    }
+    auto path = std::make_shared<Node>();
+    path->children.push_back(newPath(level - BITS, std::move(node)));
+    return path;
+}
+
+template <class T>
+typename ReduCxx::PersistentVector<T>::NodePtr
+ReduCxx::PersistentVector<T>::assoc(unsigned level, const Node& node, size_type index, T&& value)
+{
+    auto copy = std::make_shared<Node>(node);
+    if (level == 0)
+    {
+        copy->values[index & MASK] = std::move(value);
+    }
+    else
+    {
+        size_type sub = (index >> level) & MASK;
+        copy->children[sub] = assoc(level - BITS, *node.children[sub], index, std::move(value));
+    }
+    return copy;
+}
+
+#endif //REDUCXX_PERSISTENT_VECTOR_HPP
@@ -2,6 +2,9 @@
 #define REDUCXX_REDUCER_TRAITS_HPP
 
 #include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
 
 namespace ReduCxx::_impl {
 
@@ -13,19 +16,35 @@ struct ReducerTraits<S(const S&, const A&)>
 {
     typedef A Action_t;
     typedef S State_t;
+    static constexpr bool MayBeUnchanged = false;
 };
+
+// reducer returning std::nullopt when the state is unchanged
+template<class S, class A>
+struct ReducerTraits<std::optional<S>(const S&, const A&)> : public ReducerTraits<S(const S&, const A&)>
+{
+    static constexpr bool MayBeUnchanged = true;
+};
+
+// reducer consuming the previous state
+template<class S, class A>
+struct ReducerTraits<S(S&&, const A&)> : public ReducerTraits<S(const S&, const A&)> {};
+
+// reducer updating the state in place
+template<class S, class A>
+struct ReducerTraits<void(S&, const A&)> : public ReducerTraits<S(const S&, const A&)> {};
  
 // function pointer
-template<class S, class A>
-struct ReducerTraits<S(*)(const S&, const A&)> : public ReducerTraits<S(const S&, const A&)> {};
+template<class R, class ...Args>
+struct ReducerTraits<R(*)(Args...)> : public ReducerTraits<R(Args...)> {};
 
 // member function pointer
-template <class T, class S, class A>
-struct ReducerTraits<S(T::*)(const S&, const A&)> : public ReducerTraits<S(const S&, const A&)> {};
+template <class T, class R, class ...Args>
+struct ReducerTraits<R(T::*)(Args...)> : public ReducerTraits<R(Args...)> {};
  
 // const member function pointer
-template <class T, class S, class A>
-struct ReducerTraits<S(T::*)(const S&, const A&) const> : public ReducerTraits<S(const S&, const A&)> {};
+template <class T, class R, class ...Args>
+struct ReducerTraits<R(T::*)(Args...) const> : public ReducerTraits<R(Args...)> {};
 
 // functor
 template<class F>
@@ -55,6 +74,92 @@ struct ReducerTraits<std::_Binder<std::_Unforced, S(__thiscall T::*)(const S&, c
   : ReducerTraits<S(const S&, const A&)>
 {};
 
+/**
+ * @brief Invoke @a reducer whatever its shape among S(const S&, const A&),
+ * std::optional<S>(const S&, const A&), S(S&&, const A&) and
+ * void(S&, const A&), copying @a state only if the reducer needs to own it.
+ * @param changed if given, set to false when the reducer tells the state is
+ * unchanged (by returning std::nullopt), left untouched otherwise
+ */
+template<class S, class F, class A>
+S reduce(const F& reducer, const S& state, const A& action, bool* changed = nullptr)
+{
+    if constexpr (std::is_invocable_r_v<S, const F&, const S&, const A&>)
+    {
+        return reducer(state, action);
+    }
+    else if constexpr (std::is_invocable_r_v<std::optional<S>, const F&, const S&, const A&>)
+    {
+        std::optional<S> next = reducer(state, action);
+        if (changed && !next)
+        {
+            *changed = false;
+        }
+        return next ? std::move(*next) : state;
+    }
+    else if constexpr (std::is_invocable_r_v<S, const F&, S&&, const A&>)
+    {
+        return reducer(S(state), action);
+    }
+    else
+    {
+        S next(state);
+        reducer(next, action);
+        return next;
+    }
+}
+
+/**
+ * @brief Same as above but the previous @a state can be consumed (moved into
+ * the reducer or updated in place).
+ * @warning If the reducer throws, @a state may be left modified.
+ */
+template<class S, class F, class A, class = std::enable_if_t<!std::is_lvalue_reference_v<S>>>
+S reduce(const F& reducer, S&& state, const A& action, bool* changed = nullptr)
+{
+    if constexpr (std::is_invocable_r_v<S, const F&, S&&, const A&>)
+    {
+        return reducer(std::move(state), action);
+    }
+    else if constexpr (std::is_invocable_r_v<std::optional<S>, const F&, const S&, const A&>)
+    {
+        std::optional<S> next = reducer(state, action);
+        if (changed && !next)
+        {
+            *changed = false;
+        }
+        return next ? std::move(*next) : std::move(state);
+    }
+    else
+    {
+        reducer(state, action);
+        return std::move(state);
+    }
+}
+
+
+/**
+ * @brief Type-erased reducer of @a S accepting any reducer shape, it can be
+ * invoked either copying or consuming the previous state, optionally telling
+ * if the state changed (see @a reduce).
+ */
+template<class S, class A>
+class ErasedReducer
+{
+  public:
+    template<class F, class = std::enable_if_t<!std::is_same_v<F, ErasedReducer>>>
+    ErasedReducer(const F& reducer) // NOLINT(google-explicit-constructor)
+        : m_copy([reducer](const S& state, const A& action, bool* changed) { return reduce(reducer, state, action, changed); })
+        , m_consume([reducer](S&& state, const A& action, bool* changed) { return reduce(reducer, std::move(state), action, changed); })
+    { }
+
+    S operator()(const S& state, const A& action, bool* changed = nullptr) const { return m_copy(state, action, changed); }
+    S operator()(S&& state, const A& action, bool* changed = nullptr) const { return m_consume(std::move(state), action, changed); }
+
+  private:
+    std::function<S(const S&, const A&, bool*)> m_copy;
+    std::function<S(S&&, const A&, bool*)> m_consume;
+};
 
 }
 
@@ -0,0 +1,118 @@
+#ifndef REDUCXX_ROUTING_HPP
+#define REDUCXX_ROUTING_HPP
+
+#include <type_traits>
+#include <utility>
+#include "ReducerTraits.hpp"
+
+namespace ReduCxx
+{
+    template <auto... Types>
+    struct Handles;
+
+    template <auto... Types, class F>
+    auto handles(const F& reducer);
+
+    namespace _impl
+    {
+        template <class F, class H>
+        class RoutedReducer;
+
+        template <class F, class = void>
+        struct RouteTraits;
+
+        template <class... Sequences>
+        struct ConcatTypes;
+    }
+} // namespace ReduCxx
+
+/**
+ * @brief List of the action types (as returned by @a Action::type()) a
+ * reducer is interested in.
+ * A reducer declaring it, either as a nested @a handles type or by means of
+ * @a ReduCxx::handles(), is only invoked by the Composer for those actions;
+ * for any other action its sub-state is passed through untouched.
+ * Routing looks up a table indexed by action type, so declared types should be
+ * reasonably dense (as enum values usually are).
+ * @code
+ * struct CounterReducer {
+ *     using handles = ReduCxx::Handles<MyAction::INCREMENT, MyAction::DECREMENT>;
+ *     Counter operator()(const Counter& state, const MyAction& action) const;
+ * };
+ * @endcode
+ */
+template <auto... Types>
+struct ReduCxx::Handles
+{
+    using Types_t = std::integer_sequence<int, static_cast<int>(Types)...>;
+
+    static constexpr bool contains(int type) { return ((static_cast<int>(Types) == type) || ...); }
+};
+
+/**
+ * @internal
+ * @brief Attach a @a Handles list to a reducer that cannot declare it itself
+ * (plain functions, lambdas, binders).
+ */
+template <class F, class H>
+class ReduCxx::_impl::RoutedReducer
+{
+  public:
+    using handles = H;
+
+    explicit RoutedReducer(const F& reducer) : m_reducer(reducer) {}
+
+    template <class S, class A>
+    auto operator()(S&& state, const A& action) const -> decltype(std::declval<const F&>()(std::forward<S>(state), action))
+    { return m_reducer(std::forward<S>(state), action); }
+
+  private:
+    F m_reducer;
+};
+
+//! @internal a routed reducer has the same shape of the one it wraps
+template <class F, class H>
+struct ReduCxx::_impl::ReducerTraits<ReduCxx::_impl::RoutedReducer<F, H>> : ReducerTraits<F> {};
+
+//! @brief Restrict given @a reducer to the actions of given @a Types
+template <auto... Types, class F>
+auto ReduCxx::handles(const F& reducer)
+{
+    return _impl::RoutedReducer<std::decay_t<F>, Handles<Types...>>(reducer);
+}
+
+//! @internal reducers without a @a handles list are invoked for every action
+template <class F, class>
+struct ReduCxx::_impl::RouteTraits
+{
+    static constexpr bool Routed = false;
+    using Types_t = std::integer_sequence<int>;
+    static constexpr bool handles(int) { return true; }
+};
+
+template <class F>
+struct ReduCxx::_impl::RouteTraits<F, std::void_t<typename F::handles>>
+{
+    static constexpr bool Routed = true;
+    using Types_t = typename F::handles::Types_t;
+    static constexpr bool handles(int type) { return F::handles::contains(type); }
+};
+
+template <>
+struct ReduCxx::_impl::ConcatTypes<>
+{
+    using type = std::integer_sequence<int>;
+};
+
+template <int... Types>
+struct ReduCxx::_impl::ConcatTypes<std::integer_sequence<int, Types...>>
+{
+    using type = std::integer_sequence<int, Types...>;
+};
+
+template <int... First, int... Second, class... Rest>
+struct ReduCxx::_impl::ConcatTypes<std::integer_sequence<int, First...>, std::integer_sequence<int, Second...>, Rest...>
+    : ConcatTypes<std::integer_sequence<int, First..., Second...>, Rest...>
+{};
+
+#endif //REDUCXX_ROUTING_HPP
@@ -0,0 +1,41 @@
+#ifndef REDUCXX_SHARED_HPP
+#define REDUCXX_SHARED_HPP
+
+#include <memory>
+#include <utility>
+
+namespace ReduCxx
+{
+    template <class T>
+    class Shared;
+}
+
+/**
+ * @brief Immutable, reference counted box holding a (sub-)state.
+ * Copying a Shared only copies a pointer, so states made of boxes can be
+ * passed around, stored in the history or returned unchanged at no cost.
+ * @see ReduCxx::Reduce::shared
+ */
+template <class T>
+class ReduCxx::Shared
+{
+  public:
+    Shared() : m_value(std::make_shared<const T>()) { }
+
+    Shared(T value) : m_value(std::make_shared<const T>(std::move(value))) { } // NOLINT(google-explicit-constructor)
+
+    const T& get() const { return *m_value; }
+    const T& operator*() const { return *m_value; }
+    const T* operator->() const { return m_value.get(); }
+
+    //! @return true when both boxes hold the very same instance
+    [[nodiscard]] bool identical(const Shared& rhs) const { return m_value == rhs.m_value; }
+
+    bool operator==(const Shared& rhs) const { return identical(rhs) || *m_value == *rhs.m_value; }
+    bool operator!=(const Shared& rhs) const { return !(*this == rhs); }
+
+  private:
+    std::shared_ptr<const T> m_value;
+};
+
+#endif //REDUCXX_SHARED_HPP
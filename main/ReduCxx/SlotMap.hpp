@@ -0,0 +1,206 @@
+#ifndef REDUCXX_SLOT_MAP_HPP
+#define REDUCXX_SLOT_MAP_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace ReduCxx
+{
+    namespace _impl
+    {
+        struct SlotKey;
+
+        template <class T>
+        class SlotMap;
+    }
+} // namespace ReduCxx
+
+/**
+ * @internal
+ * @brief Key of an element of a SlotMap: the index of its slot and the
+ * generation of the slot when the element was inserted, so that keys of
+ * erased elements never match the elements reusing their slot.
+ * A default constructed key matches no element.
+ */
+struct ReduCxx::_impl::SlotKey
+{
+    static constexpr std::uint32_t NONE = std::numeric_limits<std::uint32_t>::max();
+
+    std::uint32_t index = NONE;
+    std::uint32_t generation = 0;
+
+    bool operator==(const SlotKey& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const SlotKey& other) const { return !(*this == other); }
+};
+
+/**
+ * @internal
+ * @brief Container with stable keys and O(1) insertion, lookup and erasure.
+ * Elements live in slots that never move: chunks of slots are added as
+ * needed, each one twice as large as the previous one, so that an element
+ * stays valid while others are inserted (and erased, but itself).
+ * Iteration visits the slots in order, skipping the free ones, so elements
+ * keep their relative order and a new element reuses the slot most recently
+ * freed, if any.
+ */
+template <class T>
+class ReduCxx::_impl::SlotMap
+{
+  public:
+    using Key = SlotKey;
+
+    SlotMap() = default;
+
+    //! Take the elements of @a temp, left empty
+    SlotMap(SlotMap&& temp) noexcept
+        : m_chunk(std::move(temp.m_chunk))
+        , m_chunks(std::exchange(temp.m_chunks, 0))
+        , m_slots(std::exchange(temp.m_slots, 0))
+        , m_free(std::exchange(temp.m_free, Key::NONE))
+        , m_size(std::exchange(temp.m_size, 0))
+    { }
+
+    SlotMap(const SlotMap&) = delete;
+    SlotMap& operator=(const SlotMap&) = delete;
+
+    Key insert(T&& value)
+    {
+        if (m_free == Key::NONE)
+        {
+            return append(std::move(value));
+        }
+        const std::uint32_t index = m_free;
+        Slot& reused = slot(index);
+        m_free = reused.next;
+        return fill(index, reused, std::move(value));
+    }
+
+    //! Same as @a insert, but never reusing a free slot: the element is past all the existing ones
+    Key append(T&& value)
+    {
+        const std::uint32_t index = m_slots;
+        if (index == capacity(m_chunks))
+        {
+            m_chunk[m_chunks] = std::make_unique<Slot[]>(FIRST << m_chunks);
+            ++m_chunks;
+        }
+        ++m_slots;
+        return fill(index, slot(index), std::move(value));
+    }
+
+    //! Element of given @a key, null if erased
+    T* find(const Key& key)
+    {
+        return contains(key) ? &*slot(key.index).value : nullptr;
+    }
+
+    bool contains(const Key& key) const
+    {
+        if (key.index >= m_slots)
+        {
+            return false;
+        }
+        const Slot& used = slot(key.index);
+        return used.generation == key.generation && used.value.has_value();
+    }
+
+    //! Erase the element of given @a key, return false if already erased
+    bool erase(const Key& key)
+    {
+        if (!contains(key))
+        {
+            return false;
+        }
+        Slot& freed = slot(key.index);
+        freed.value.reset();
+        ++freed.generation;
+        freed.next = m_free;
+        m_free = key.index;
+        --m_size;
+        return true;
+    }
+
+    //! Number of elements
+    std::size_t size() const { return m_size; }
+
+    //! Number of slots, used or free, to iterate with @a at
+    std::size_t slots() const { return m_slots; }
+
+    //! Element in slot @a index, null if free
+    T* at(std::size_t index)
+    {
+        Slot& used = slot(static_cast<std::uint32_t>(index));
+        return used.value ? &*used.value : nullptr;
+    }
+
+    //! Key of the element in slot @a index
+    Key keyAt(std::size_t index) const
+    {
+        const auto i = static_cast<std::uint32_t>(index);
+        return { i, slot(i).generation };
+    }
+
+  private:
+    static constexpr std::uint32_t FIRST = 8;   // slots of the first chunk
+    static constexpr std::size_t CHUNKS = 29;   // enough for any 32 bits index
+
+    struct Slot
+    {
+        std::optional<T> value;
+        std::uint32_t generation = 0;   // increased at each erasure
+        std::uint32_t next = Key::NONE; // next free slot, if free
+    };
+
+    std::array<std::unique_ptr<Slot[]>, CHUNKS> m_chunk;
+    std::size_t m_chunks = 0;
+    std::uint32_t m_slots = 0;          // used or free
+    std::uint32_t m_free = Key::NONE;   // head of the free slots list
+    std::size_t m_size = 0;
+
+    //! Number of slots in the first @a chunks chunks
+    static std::uint32_t capacity(std::size_t chunks) { return FIRST * ((std::uint32_t(1) << chunks) - 1); }
+
+    //! Chunk of the slot of given @a index: chunk k starts at capacity(k)
+    static std::uint32_t chunkOf(std::uint32_t index)
+    {
+        const std::uint32_t rank = index / FIRST + 1;
+#if defined __GNUC__
+        return 31 - static_cast<std::uint32_t>(__builtin_clz(rank));
+#else
+        std::uint32_t chunk = 0;
+        for (std::uint32_t rest = rank; rest > 1; rest >>= 1)
+        {
+            ++chunk;
+        }
+        return chunk;
+#endif
+    }
+
+    Slot& slot(std::uint32_t index)
+    {
+        const std::uint32_t chunk = chunkOf(index);
+        return m_chunk[chunk][index - capacity(chunk)];
+    }
+
+    const Slot& slot(std::uint32_t index) const
+    {
+        const std::uint32_t chunk = chunkOf(index);
+        return m_chunk[chunk][index - capacity(chunk)];
+    }
+
+    Key fill(std::uint32_t index, Slot& target, T&& value)
+    {
+        target.value.emplace(std::move(value));
+        target.next = Key::NONE;
+        ++m_size;
+        return { index, target.generation };
+    }
+};
+
+#endif //REDUCXX_SLOT_MAP_HPP
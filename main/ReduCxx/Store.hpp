@@ -2,33 +2,69 @@
 #define REDUCXX_STORE_HPP
 
 #include "Composer.hpp"
+#include "History.hpp"
+#include "InplaceFunction.hpp"
+#include "SlotMap.hpp"
 #include "StoreSubscriptionsError.hpp"
+#include <array>
+#include <cstdint>
 #include <functional>
-#include <list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <tuple>
 
 namespace ReduCxx
 {
-    template <class S, class A>
+    template <class S, class A, class R = _impl::ErasedReducer<S, A>>
     class Store;
+
+    //! Token of a subscription to a Store, see @a Store::unsubscribe; a default one matches none
+    using Subscription = _impl::SlotKey;
+
+    namespace _impl
+    {
+        template <class S>
+        struct SliceCount;
+    }
 }
 
+//! @internal number of independently versioned parts of a state
+template <class S>
+struct ReduCxx::_impl::SliceCount : std::integral_constant<std::size_t, 1> {};
+
+template <class... Ts>
+struct ReduCxx::_impl::SliceCount<std::tuple<Ts...>> : std::integral_constant<std::size_t, sizeof...(Ts)> {};
+
 /**
  * @brief Plain/basic ReduCpp Store with no concurrency support.
+ * The reducer type @a R is type-erased by default; Stores built by
+ * @a StoreFactory are instead bound to the actual Composer type, so that the
+ * whole reducer tree can be inlined into @a dispatch.
  */
-template <class S, class A>
+template <class S, class A, class R>
 class ReduCxx::Store
 {
   public:
-    typedef std::function<S(const S &, const A &)> reducer_t;
-    typedef std::function<void()> callback_t;
+    typedef R reducer_t;
+    typedef _impl::InplaceFunction<void(const S&)> callback_t;
 
+    /**
+     * @brief Build a Store around given @a reducer, starting from a default
+     * constructed state.
+     * The reducer may have any of the shapes S(const S&, const A&),
+     * std::optional<S>(const S&, const A&), S(S&&, const A&) or
+     * void(S&, const A&). When no previous state is retained (history depth
+     * of 1) the current state is moved into the latter two instead of being
+     * copied: should they throw, the state is left as they modified it.
+     * @param history how many states to retain for @a revert(); unbounded by
+     * default, long-running stores should rather use a bounded one.
+     */
     template <class F>
-    explicit Store(const F& reducer) : m_reducer(reducer)
-    {
-        m_history.push_back(S());
-    }
+    explicit Store(const F& reducer, const HistoryPolicy& history = HistoryPolicy::unbounded());
 
     //! Move constructor (used for StoreFactory facilities)
     Store(Store&& temp) noexcept;
@@ -51,71 +87,418 @@ class ReduCxx::Store
 
     void dispatch(const A& action);
 
+    /**
+     * @brief Reduce all the actions in [@a first, @a last) as if they were
+     * one: a single state is added to the history (so @a revert rolls back
+     * the whole batch) and subscriptions run once, at the end.
+     * Unless the reducers consume the state, a reducer throwing leaves the
+     * state as it was before the batch.
+     * @note Iterators are traversed twice by event-sourced histories, so they
+     * shall be forward iterators.
+     */
+    template <class It>
+    void dispatchBatch(It first, It last);
+
+    /**
+     * @brief Run @a op deferring subscriptions: the dispatches it performs
+     * update the state right away, but subscriptions run only once at the end
+     * (if anything was dispatched), with @a dirty() covering all of them.
+     * Unlike @a dispatchBatch each dispatch keeps its own history entry and
+     * the ones preceding a throwing reducer are kept.
+     */
+    template <class F>
+    void deferNotifications(F&& op);
+
+    /**
+     * @brief Roll back to the previous state, if still retained.
+     * Every sub-state is then reported as changed.
+     * @return false if there is no previous state to go back to
+     */
     bool revert();
 
+    /**
+     * @brief Return the version of the sub-state of index @a I (of the whole
+     * state if @a S is not a std::tuple), increased each time it changes.
+     * Comparing versions is a cheap substitute for comparing sub-states.
+     */
+    template <size_t I = 0>
+    std::uint64_t version() const { return std::get<I>(m_versions); }
+
+    /**
+     * @brief Return which sub-states changed in the last @a dispatch or
+     * @a revert, bit I standing for the sub-state of index @a I.
+     * Only Stores bound to a Composer (as built by @a StoreFactory) know which
+     * sub-states their reducers left untouched; other ones report all of
+     * them as changed unless the reducer returned std::nullopt.
+     */
+    DirtyMask dirty() const { return m_dirty; }
+
     /**
      * @brief Subscribe given @a callback to be called at each state change.
      * If any of the callbacks throws, the exception is put in stasis until all
      * the subscriptions are run, then a special @a umbrella exception will be
-     * thrown storing a list of all exceptions 
+     * thrown storing a list of all exceptions.
+     * Callbacks are stored inline when small enough (lambdas capturing a few
+     * references or pointers), so that a dispatch whose subscribers do not
+     * throw performs no heap allocation.
+     * A callback subscribed by a subscription is called from the next state
+     * change on.
+     * @return the token to @a unsubscribe the callback
      */
     template <class F>
-    void subscribe(const F& callback)
-    { m_subscriptions.push_back(callback); }
+    Subscription subscribe(const F& callback)
+    { return add([callback](const S&) mutable { callback(); }); }
+
+    /**
+     * @brief Subscribe given @a callback to changes of the slice of the state
+     * projected by @a selector.
+     * The last projected value is memoized and @a callback is only called,
+     * with the new value, when the projection differs from it according to
+     * @a equal: comparing versions or identities (e.g. @a Shared::identical)
+     * rather than values keeps the check cheap for large slices.
+     * Errors are reported as for the plain subscriptions.
+     * @code
+     * store.subscribe([](const State& s) { return s.counter; },
+     *                 [](int counter) { std::cout << counter; });
+     * @endcode
+     */
+    template <class Selector, class F, class Equal = std::equal_to<>>
+    Subscription subscribe(const Selector& selector, const F& callback, const Equal& equal = Equal());
+
+    /**
+     * @brief Remove the subscription of given @a token, in constant time.
+     * It can be called by the subscriptions themselves, the removed one is
+     * then not called anymore (and destroyed once they all ran).
+     * Subscriptions run in subscription order, except that a new one takes
+     * the place of the last removed one.
+     * @return false if already removed
+     */
+    bool unsubscribe(const Subscription& token);
+
+    /**
+     * @brief Tie the subscription of given @a token to the lifetime of
+     * @a owner: it is removed by the first state change finding @a owner
+     * expired, instead of being called.
+     * @return false if the subscription was removed
+     */
+    bool tie(const Subscription& token, std::weak_ptr<const void> owner);
 
   protected:
     void performCallbacks();
 
+    Subscription add(callback_t&& callback);
+
   private:
+    static constexpr std::size_t SLICES = _impl::SliceCount<S>::value;
+    static_assert(SLICES <= 8 * sizeof(DirtyMask), "too many sub-states to track their changes");
+    static constexpr DirtyMask ALL_DIRTY = SLICES < 64 ? (DirtyMask(1) << SLICES) - 1 : ~DirtyMask(0);
+
+    template <class State>
+    S reduce(State&& state, const A& action, DirtyMask& dirty) const;
+
+    void commit(S&& state, DirtyMask dirty);
+
+    void touchAll();
+
     const reducer_t m_reducer;
-    std::list<S> m_history;
-    std::vector<callback_t> m_subscriptions;
+    const bool m_consume; // whether the current state can be moved into the reducer
+    _impl::History<S> m_history;
+    std::unique_ptr<_impl::ActionLog<S, A>> m_log; // only for event-sourced histories
+    struct Subscriber
+    {
+        callback_t callback;
+        int order;                          // of its subscription, to report its errors
+        std::weak_ptr<const void> owner;    // see tie
+        bool tied = false;
+        bool removed = false;               // while notifying, erased afterwards
+    };
+
+    _impl::SlotMap<Subscriber> m_subscriptions;
+    std::vector<Subscription> m_removed;    // while notifying
+    int m_notifying = 0;                    // depth of performCallbacks, dispatching from subscriptions nests it
+    int m_subscribed = 0;                   // subscriptions made so far
+    std::array<std::uint64_t, SLICES> m_versions {};
+    DirtyMask m_dirty = 0;
+    bool m_deferring = false;   // within deferNotifications
+    bool m_deferred = false;    // a state change is waiting for subscriptions
 };
 
-template <class S, class A>
-ReduCxx::Store<S, A>::Store(Store&& temp) noexcept
+template <class S, class A, class R>
+template <class F>
+ReduCxx::Store<S, A, R>::Store(const F& reducer, const HistoryPolicy& history)
+    : m_reducer(reducer)
+    , m_consume(!history.isEventSourced() && history.depth() == 1)
+    , m_history(history.isEventSourced() ? HistoryPolicy::bounded(1) : history)
+{
+    if (history.isEventSourced())
+    {
+        if constexpr (std::is_copy_constructible_v<A>)
+        {
+            m_log = std::make_unique<_impl::ActionLog<S, A>>(history);
+        }
+        else
+        {
+            throw std::logic_error("event-sourced history requires copyable actions");
+        }
+    }
+}
+
+template <class S, class A, class R>
+template <class Selector, class F, class Equal>
+ReduCxx::Subscription ReduCxx::Store<S, A, R>::subscribe(const Selector& selector, const F& callback, const Equal& equal)
+{
+    using slice_t = std::decay_t<std::invoke_result_t<const Selector&, const S&>>;
+    return add([selector, callback, equal, last = slice_t(selector(state()))](const S& reached) mutable {
+        slice_t current = selector(reached);
+        if (equal(std::as_const(last), std::as_const(current)))
+        {
+            return;
+        }
+        last = std::move(current);
+        callback(std::as_const(last));
+    });
+}
+
+template <class S, class A, class R>
+ReduCxx::Subscription ReduCxx::Store<S, A, R>::add(callback_t&& callback)
+{
+    if (m_notifying > 0)
+    {
+        // from a subscription: not called for the current change, as if subscribed after it
+        return m_subscriptions.append({ std::move(callback), m_subscribed++, {}, false, false });
+    }
+    return m_subscriptions.insert({ std::move(callback), m_subscribed++, {}, false, false });
+}
+
+template <class S, class A, class R>
+bool ReduCxx::Store<S, A, R>::unsubscribe(const Subscription& token)
+{
+    Subscriber* subscriber = m_subscriptions.find(token);
+    if (!subscriber || subscriber->removed)
+    {
+        return false;
+    }
+    if (m_notifying > 0)
+    {
+        // erasing would destroy the callback, which may be the running one
+        subscriber->removed = true;
+        m_removed.push_back(token);
+        return true;
+    }
+    return m_subscriptions.erase(token);
+}
+
+template <class S, class A, class R>
+bool ReduCxx::Store<S, A, R>::tie(const Subscription& token, std::weak_ptr<const void> owner)
+{
+    Subscriber* subscriber = m_subscriptions.find(token);
+    if (!subscriber || subscriber->removed)
+    {
+        return false;
+    }
+    subscriber->owner = std::move(owner);
+    subscriber->tied = true;
+    return true;
+}
+
+template <class S, class A, class R>
+ReduCxx::Store<S, A, R>::Store(Store&& temp) noexcept
     : m_reducer(std::move(temp.m_reducer))
+    , m_consume(temp.m_consume)
     , m_history(std::move(temp.m_history))
+    , m_log(std::move(temp.m_log))
     , m_subscriptions(std::move(temp.m_subscriptions))
+    , m_subscribed(temp.m_subscribed)
+    , m_versions(temp.m_versions)
+    , m_dirty(temp.m_dirty)
 { }
 
-template <class S, class A>
-void ReduCxx::Store<S, A>::dispatch(const A& action)
+template <class S, class A, class R>
+void ReduCxx::Store<S, A, R>::dispatch(const A& action)
+{
+    DirtyMask dirty;
+    S state = m_consume ? reduce(std::move(m_history.back()), action, dirty)
+                        : reduce(std::as_const(m_history.back()), action, dirty);
+    if constexpr (std::is_copy_constructible_v<A>)
+    {
+        if (m_log)
+        {
+            m_log->record(action, state);
+        }
+    }
+    commit(std::move(state), dirty);
+}
+
+template <class S, class A, class R>
+template <class It>
+void ReduCxx::Store<S, A, R>::dispatchBatch(It first, It last)
+{
+    if (first == last)
+    {
+        return;
+    }
+    DirtyMask dirty;
+    S state = m_consume ? reduce(std::move(m_history.back()), *first, dirty)
+                        : reduce(std::as_const(m_history.back()), *first, dirty);
+    for (It it = std::next(first); it != last; ++it)
+    {
+        DirtyMask next;
+        state = reduce(std::move(state), *it, next);
+        dirty |= next;
+    }
+    if constexpr (std::is_copy_constructible_v<A>)
+    {
+        if (m_log)
+        {
+            m_log->record(first, last, state);
+        }
+    }
+    commit(std::move(state), dirty);
+}
+
+template <class S, class A, class R>
+template <class State>
+S ReduCxx::Store<S, A, R>::reduce(State&& state, const A& action, DirtyMask& dirty) const
+{
+    if constexpr (std::is_invocable_r_v<S, const R&, State&&, const A&, DirtyMask&>)
+    {
+        return m_reducer(std::forward<State>(state), action, dirty);
+    }
+    else if constexpr (std::is_invocable_r_v<S, const R&, State&&, const A&, bool*>) // erased reducer
+    {
+        bool changed = true;
+        S next = m_reducer(std::forward<State>(state), action, &changed);
+        dirty = changed ? ALL_DIRTY : 0;
+        return next;
+    }
+    else
+    {
+        bool changed = true;
+        S next = _impl::reduce(m_reducer, std::forward<State>(state), action, &changed);
+        dirty = changed ? ALL_DIRTY : 0;
+        return next;
+    }
+}
+
+template <class S, class A, class R>
+void ReduCxx::Store<S, A, R>::commit(S&& state, DirtyMask dirty)
 {
-    m_history.push_back(m_reducer(m_history.back(), action));
+    m_history.push(std::move(state));
+    m_dirty = m_deferred ? m_dirty | dirty : dirty;
+    for (std::size_t i = 0; i < SLICES; ++i)
+    {
+        m_versions[i] += (dirty >> i) & 1;
+    }
+    if (m_deferring)
+    {
+        m_deferred = true;
+        return;
+    }
     performCallbacks();
 }
 
-template <class S, class A>
-bool ReduCxx::Store<S, A>::revert()
+template <class S, class A, class R>
+template <class F>
+void ReduCxx::Store<S, A, R>::deferNotifications(F&& op)
+{
+    if (m_deferring)
+    {
+        op();
+        return;
+    }
+    m_deferring = true;
+    try
+    {
+        op();
+    }
+    catch (...)
+    {
+        m_deferring = false;
+        if (std::exchange(m_deferred, false))
+        {
+            performCallbacks();
+        }
+        throw;
+    }
+    m_deferring = false;
+    if (std::exchange(m_deferred, false))
+    {
+        performCallbacks();
+    }
+}
+
+template <class S, class A, class R>
+bool ReduCxx::Store<S, A, R>::revert()
 {
-    if (m_history.size() == 1)
+    if constexpr (std::is_copy_constructible_v<A>)
+    {
+        if (m_log)
+        {
+            std::optional<S> previous = m_log->revert([this](const S& state, const A& action) {
+                return _impl::reduce(m_reducer, state, action);
+            });
+            if (!previous)
+            {
+                return false;
+            }
+            m_history.push(std::move(*previous));
+            touchAll();
+            return true;
+        }
+    }
+    if (!m_history.pop())
     {
         return false;
     }
-    else
+    touchAll();
+    return true;
+}
+
+template <class S, class A, class R>
+void ReduCxx::Store<S, A, R>::touchAll()
+{
+    m_dirty = ALL_DIRTY;
+    for (std::uint64_t& version : m_versions)
     {
-        m_history.pop_back();
-        return true;
+        ++version;
     }
 }
 
-template <class S, class A>
-void ReduCxx::Store<S, A>::performCallbacks()
+template <class S, class A, class R>
+void ReduCxx::Store<S, A, R>::performCallbacks()
 {
-    std::vector<StoreSubscriptionsError::error> exceptions;
-    int idx = 0;
-    for (const callback_t& callback : m_subscriptions)
+    std::vector<StoreSubscriptionsError::error> exceptions; // allocates on first error only
+    ++m_notifying;
+    // subscriptions added meanwhile are past the end, see add
+    const std::size_t end = m_subscriptions.slots();
+    for (std::size_t i = 0; i < end; ++i)
     {
+        Subscriber* subscriber = m_subscriptions.at(i);
+        if (!subscriber || subscriber->removed)
+        {
+            continue;
+        }
+        if (subscriber->tied && subscriber->owner.expired())
+        {
+            unsubscribe(m_subscriptions.keyAt(i));
+            continue;
+        }
         try 
         {
-            callback();
+            subscriber->callback(m_history.back());
         } 
         catch (...) 
         {
-            exceptions.push_back(std::make_pair(idx, std::current_exception()));
+            exceptions.push_back(std::make_pair(subscriber->order, std::current_exception()));
+        }
+    }
+    if (--m_notifying == 0)
+    {
+        for (const Subscription& token : m_removed)
+        {
+            m_subscriptions.erase(token);
         }
-        ++idx;
+        m_removed.clear();
     }
 
     if (!exceptions.empty())
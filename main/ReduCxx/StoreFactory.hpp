@@ -3,25 +3,117 @@
 
 #include "Store.hpp"
 #include "ReduCxx/Async/AsyncStore.hpp"
+#include "ReduCxx/Async/ParallelComposer.hpp"
+#include "ReduCxx/Async/ShardedAsyncStore.hpp"
 
 namespace ReduCxx {
     template <class A>
     struct StoreFactory;
 }
 
+/**
+ * @brief Build Stores out of a list of reducers, one per sub-state.
+ * Returned Stores are bound to the actual Composer type (no type erasure of
+ * the reducers), use a plain @a Store<S, A> if you need a common type.
+ */
 template <class A>
 struct ReduCxx::StoreFactory {
     template <class ...Reducers>
     static auto make(const Reducers& ...reducers) {
-        using CompositeState = typename Composer<A, Reducers...>::CompositeState;
-        return Store<CompositeState, A>(Reduce<A>::with(reducers...));
+        return make(HistoryPolicy::unbounded(), reducers...);
+    }
+
+    //! Same as @a make but with a custom @a history retention policy
+    template <class ...Reducers>
+    static auto make(const HistoryPolicy& history, const Reducers& ...reducers) {
+        auto composer = Reduce<A>::with(reducers...);
+        using Reducer = decltype(composer);
+        return Store<typename Reducer::CompositeState, A, Reducer>(composer, history);
+    }
+
+    /**
+     * @brief Make a Store whose sub-states are @a Shared boxes, see
+     * @a Reduce::shared. Sub-states left unchanged by their reducer are not
+     * copied on dispatch.
+     */
+    template <class ...Reducers>
+    static auto makeShared(const Reducers& ...reducers) {
+        return makeShared(HistoryPolicy::unbounded(), reducers...);
+    }
+
+    template <class ...Reducers>
+    static auto makeShared(const HistoryPolicy& history, const Reducers& ...reducers) {
+        auto composer = Reduce<A>::shared(reducers...);
+        using Reducer = decltype(composer);
+        return Store<typename Reducer::CompositeState, A, Reducer>(composer, history);
     }
 
     template <class ...Reducers>
     static auto makeAsync(const Reducers& ...reducers) {
-        using CompositeState = typename Composer<A, Reducers...>::CompositeState;
-        return AsyncStore<CompositeState, A>(Reduce<A>::with(reducers...));
+        return makeAsync(HistoryPolicy::bounded(1), reducers...);
+    }
+
+    //! Same as @a makeAsync but with a custom @a history retention policy
+    template <class ...Reducers>
+    static auto makeAsync(const HistoryPolicy& history, const Reducers& ...reducers) {
+        return makeAsync(history, DispatchPolicy::sequential(), reducers...);
+    }
+
+    //! Same as @a makeAsync but with a custom @a dispatch policy
+    template <class ...Reducers>
+    static auto makeAsync(const DispatchPolicy& dispatch, const Reducers& ...reducers) {
+        return makeAsync(HistoryPolicy::bounded(1), dispatch, reducers...);
+    }
+
+    template <class ...Reducers>
+    static auto makeAsync(const HistoryPolicy& history, const DispatchPolicy& dispatch, const Reducers& ...reducers) {
+        auto composer = Reduce<A>::with(reducers...);
+        using Reducer = decltype(composer);
+        return AsyncStore<typename Reducer::CompositeState, A, Reducer>(composer, history, dispatch);
+    }
+
+    /**
+     * @brief Make a Store whose reducers run concurrently on given @a pool,
+     * see @a ParallelComposer. Only worth it for heavy reducers.
+     */
+    template <class ...Reducers>
+    static auto makeParallel(ThreadPool& pool, const Reducers& ...reducers) {
+        return makeParallel(pool, HistoryPolicy::unbounded(), reducers...);
+    }
+
+    template <class ...Reducers>
+    static auto makeParallel(ThreadPool& pool, const HistoryPolicy& history, const Reducers& ...reducers) {
+        ParallelComposer<A, Reducers...> composer(pool, reducers...);
+        using Reducer = decltype(composer);
+        return Store<typename Reducer::CompositeState, A, Reducer>(composer, history);
+    }
+
+    //! Asynchronous flavour of @a makeParallel
+    template <class ...Reducers>
+    static auto makeParallelAsync(ThreadPool& pool, const Reducers& ...reducers) {
+        ParallelComposer<A, Reducers...> composer(pool, reducers...);
+        using Reducer = decltype(composer);
+        return AsyncStore<typename Reducer::CompositeState, A, Reducer>(composer);
+    }
+
+    /**
+     * @brief Make a ShardedAsyncStore of @a shards shards, dispatching each
+     * action to the shard of the key extracted by @a keyOf.
+     */
+    template <class K, class ...Reducers>
+    static auto makeSharded(const K& keyOf, std::size_t shards, const Reducers& ...reducers) {
+        auto composer = Reduce<A>::with(reducers...);
+        using Reducer = decltype(composer);
+        return ShardedAsyncStore<typename Reducer::CompositeState, A, Reducer>(composer, keyOf, shards);
+    }
+
+    //! Asynchronous flavour of @a makeShared
+    template <class ...Reducers>
+    static auto makeSharedAsync(const Reducers& ...reducers) {
+        auto composer = Reduce<A>::shared(reducers...);
+        using Reducer = decltype(composer);
+        return AsyncStore<typename Reducer::CompositeState, A, Reducer>(composer);
     }
 };
 
-#endif //REDUCXX_STORE_FACTORY_HPP
\ No newline at end of file
+#endif //REDUCXX_STORE_FACTORY_HPP
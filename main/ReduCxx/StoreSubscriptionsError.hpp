@@ -9,6 +9,11 @@ namespace ReduCxx {
     class StoreSubscriptionsError;
 }
 
+/**
+ * @brief Exceptions thrown by the subscriptions notified of a state change,
+ * each one with the index of its subscription: 0 for the first subscription
+ * made to the Store, 1 for the next one, and so on, whichever were removed.
+ */
 class ReduCxx::StoreSubscriptionsError : public std::exception
 {
   public:
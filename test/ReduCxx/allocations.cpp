@@ -0,0 +1,232 @@
+#include <ReduCxx/Store.hpp>
+#include <ReduCxx/Async/AsyncStore.hpp>
+#include "../catch.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+using namespace ReduCxx;
+
+// Count the heap allocations of the current thread, other tests may run
+// concurrently on their own threads.
+
+namespace {
+    thread_local std::size_t t_allocations = 0;
+
+    void* allocate(std::size_t size)
+    {
+        ++t_allocations;
+        if (void* ptr = std::malloc(size > 0 ? size : 1))
+        {
+            return ptr;
+        }
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+SCENARIO("allocation-free dispatch")
+{
+    struct MyState
+    {
+        int value;
+    };
+
+    struct MyAction
+    {
+        int delta;
+    };
+
+    Store<MyState, MyAction> sut([](const MyState& state, const MyAction& action) -> MyState {
+        return { state.value + action.delta };
+    }, HistoryPolicy::bounded(2));
+
+    GIVEN("a Store with many non-throwing subscribers")
+    WHEN("an action is dispatched")
+    THEN("no heap allocation happens")
+    {
+        int calls = 0;
+        const MyState* seen = nullptr;
+        for (int i = 0; i < 16; ++i)
+        {
+            sut.subscribe([&calls, &seen, &sut]() {
+                ++calls;
+                seen = &sut.state();
+            });
+        }
+        sut.dispatch({ 1 }); // warm-up
+
+        const std::size_t before = t_allocations;
+        for (int i = 0; i < 100; ++i)
+        {
+            sut.dispatch({ 1 });
+        }
+        const std::size_t allocations = t_allocations - before;
+
+        CHECK(allocations == 0);
+        CHECK(calls == 16 * 101);
+        CHECK(seen->value == 101);
+    }
+
+    GIVEN("a Store with a subscriber too big to be stored inline")
+    WHEN("an action is dispatched")
+    THEN("the subscriber is boxed once, not at each dispatch")
+    {
+        char payload[256] = { 42 };
+        int calls = 0;
+        const std::size_t before = t_allocations;
+        sut.subscribe([payload, &calls]() { calls += payload[0]; });
+        CHECK(t_allocations - before <= 2); // the box, plus the subscriptions vector
+
+        const std::size_t subscribed = t_allocations;
+        sut.dispatch({ 1 });
+        CHECK(t_allocations == subscribed);
+        CHECK(calls == 42);
+    }
+
+    GIVEN("a Store with throwing subscribers")
+    WHEN("an action is dispatched")
+    THEN("errors are still collected")
+    {
+        sut.subscribe([]() { throw std::runtime_error("first"); });
+        sut.subscribe([]() {});
+        sut.subscribe([]() { throw std::runtime_error("second"); });
+        try
+        {
+            sut.dispatch({ 1 });
+            FAIL("expected StoreSubscriptionsError");
+        }
+        catch (const StoreSubscriptionsError& error)
+        {
+            REQUIRE(error.errors().size() == 2);
+            CHECK(error.errors()[0].first == 0);
+            CHECK(error.errors()[1].first == 2);
+        }
+        CHECK(sut.state().value == 1);
+    }
+}
+
+SCENARIO("allocation-free asynchronous dispatch")
+{
+    struct MyState
+    {
+        int value;
+    };
+
+    struct MyAction
+    {
+        int delta;
+    };
+
+    std::atomic<bool> warm { false };
+    AsyncStore<MyState, MyAction> sut([&warm](const MyState& state, const MyAction& action) -> MyState {
+        while (!warm)
+        {
+            std::this_thread::yield();
+        }
+        return { state.value + action.delta };
+    });
+
+    GIVEN("an AsyncStore whose pools have grown")
+    WHEN("small actions are dispatched")
+    THEN("the dispatching thread does not allocate")
+    {
+        // hold the reducers thread, so that the pools grow to the largest backlog
+        for (int i = 0; i < 100; ++i)
+        {
+            sut.dispatch({ 1 });
+            sut.dispatchDetached({ 1 });
+        }
+        warm = true;
+        sut.dispatch({ 0 }).get();
+
+        const std::size_t before = t_allocations;
+        for (int i = 0; i < 100; ++i)
+        {
+            sut.dispatch({ 1 });
+            sut.dispatchDetached({ 1 });
+        }
+        std::future<void> done = sut.dispatch({ 0 });
+        const std::size_t allocations = t_allocations - before;
+        done.get();
+
+        CHECK(allocations == 0);
+        CHECK(sut.state().value == 400);
+    }
+}
+
+SCENARIO("allocation-free revert")
+{
+    GIVEN("a history of boxed states")
+    WHEN("its states are popped")
+    THEN("the reverted ones are released and no box is allocated in their place")
+    {
+        _impl::History<Shared<std::shared_ptr<int>>> sut(HistoryPolicy::bounded(4));
+        sut.push(std::make_shared<int>(1));
+        std::shared_ptr<int> last = std::make_shared<int>(2);
+        std::weak_ptr<int> reverted = last;
+        sut.push(std::move(last));
+
+        const std::size_t before = t_allocations;
+        CHECK(sut.pop());
+        const std::size_t allocations = t_allocations - before;
+
+        CHECK(allocations == 0);
+        CHECK(reverted.expired());
+        CHECK(**sut.back() == 1);
+    }
+}
+
+SCENARIO("allocation-free counting subscriptions")
+{
+    struct MyState
+    {
+        int value;
+    };
+
+    AsyncStore<MyState, int> sut([](const MyState& state, const int& action) -> MyState {
+        return { state.value + action };
+    });
+
+    GIVEN("an AsyncStore with an async subscriber tracked by counters")
+    WHEN("its pools have grown and state changes are notified")
+    THEN("the reducers thread does not allocate")
+    {
+        ActiveObject<void> worker;
+        std::atomic<int> seen { 0 };
+        std::shared_ptr<SubscriptionHandle> handle = sut.subscribeAsync(worker, TrackingPolicy::counters(), [&]() {
+            ++seen;
+        });
+        // a larger backlog than the measured one, for the subscriber queue to grow
+        for (int i = 0; i < 1000; ++i)
+        {
+            sut.dispatchDetached(1);
+        }
+        sut.dispatch(1).get();
+        handle->waitAll();
+
+        std::size_t before = 0;
+        std::size_t after = 0;
+        sut.post([&]() { before = t_allocations; });
+        for (int i = 0; i < 100; ++i)
+        {
+            sut.dispatchDetached(1);
+        }
+        sut.post([&]() { after = t_allocations; }).get();
+        handle->waitAll();
+
+        CHECK(after - before == 0);
+        CHECK(seen == 1101);
+        CHECK(handle->completed() == 1101);
+        CHECK(handle->count() == 0);
+    }
+}
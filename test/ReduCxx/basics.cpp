@@ -113,4 +113,24 @@ SCENARIO("basic functionality")
         CHECK(got_exception);
         CHECK(run_anyway);
     }
+
+    GIVEN("a Store whose first subscription was removed")
+    WHEN("a later subscriber throws")
+    THEN("its error is reported with the index of its subscription")
+    {
+        ReduCxx::Subscription first = sut.subscribe( []() { });
+        sut.subscribe( []() { });
+        sut.unsubscribe(first);
+        sut.subscribe( []() { throw "error"; });
+        try 
+        {
+            sut.dispatch( {MyAction::INCREMENT });
+            FAIL("no exception");
+        }
+        catch (ReduCxx::StoreSubscriptionsError& ex)
+        {
+            REQUIRE(ex.errors().size() == 1);
+            CHECK(ex.errors()[0].first == 2);
+        }
+    }
 }
@@ -127,3 +127,140 @@ SCENARIO("behavioural checks")
     }
 }
 
+
+namespace {
+    struct RoutedCounter {
+        using handles = Handles<MyAction::INCREMENT>;
+        int* calls;
+        MyState1 operator()(const MyState1& state, const MyAction& action) const {
+            ++*calls;
+            return { state.value + 1 };
+        }
+    };
+}
+
+SCENARIO("action routing")
+{
+    GIVEN("a composite Store whose reducers declare the actions they handle")
+    WHEN("dispatching an action")
+    THEN("only the interested reducers are invoked")
+    {
+        int incrementCalls = 0;
+        int decrementCalls = 0;
+        int allCalls = 0;
+
+        auto sut = StoreFactory<MyAction>::make(
+            RoutedCounter { &incrementCalls },
+            handles<MyAction::DECREMENT>([&](const MyState2& state, const MyAction&) -> MyState2 {
+                ++decrementCalls;
+                return { state.value - 1 };
+            }),
+            [&](const int& state, const MyAction&) {   // no declaration: handles everything
+                ++allCalls;
+                return state + 1;
+            });
+
+        sut.dispatch({ MyAction::INCREMENT });
+        sut.dispatch({ MyAction::INCREMENT });
+        sut.dispatch({ MyAction::DECREMENT });
+        CHECK(incrementCalls == 2);
+        CHECK(decrementCalls == 1);
+        CHECK(allCalls == 3);
+        CHECK(sut.state<MyState1>().value == 2);
+        CHECK(sut.state<MyState2>().value == -1);
+        CHECK(sut.state<int>() == 3);
+
+        sut.dispatch({ static_cast<MyAction::TYPE>(42) }); // unknown to every routed reducer
+        CHECK(incrementCalls == 2);
+        CHECK(decrementCalls == 1);
+        CHECK(allCalls == 4);
+    }
+
+    GIVEN("a Store made of shared sub-states with routed reducers")
+    WHEN("dispatching an action")
+    THEN("boxes of the skipped reducers are kept")
+    {
+        auto sut = StoreFactory<MyAction>::makeShared(
+            handles<MyAction::INCREMENT>(dummyReducer),
+            handles<MyAction::DECREMENT>([](const MyState2& state, const MyAction&) -> MyState2 {
+                return { state.value - 1 };
+            }));
+
+        Shared<MyState2> before = sut.state<1>();
+        sut.dispatch({ MyAction::INCREMENT });
+        CHECK(sut.state<0>()->value == 1);
+        CHECK(sut.state<1>().identical(before));
+    }
+}
+
+SCENARIO("sub-state versions")
+{
+    GIVEN("a composite Store with routed reducers")
+    WHEN("dispatching actions")
+    THEN("only the versions of the reduced sub-states increase")
+    {
+        auto sut = StoreFactory<MyAction>::make(
+            handles<MyAction::INCREMENT>(dummyReducer),
+            handles<MyAction::DECREMENT>([](const MyState2& state, const MyAction&) -> MyState2 {
+                return { state.value - 1 };
+            }),
+            [](const int& state, const MyAction& action) -> std::optional<int> {
+                if (action.type() == MyAction::DECREMENT) return std::nullopt;
+                return state + 1;
+            });
+
+        CHECK(sut.dirty() == 0);
+        sut.dispatch({ MyAction::INCREMENT });
+        CHECK(sut.dirty() == 0b101);
+        CHECK(sut.version<0>() == 1);
+        CHECK(sut.version<1>() == 0);
+        CHECK(sut.version<2>() == 1);
+
+        sut.dispatch({ MyAction::DECREMENT });
+        CHECK(sut.dirty() == 0b010);
+        CHECK(sut.version<0>() == 1);
+        CHECK(sut.version<1>() == 1);
+        CHECK(sut.version<2>() == 1);
+
+        CHECK(sut.revert());
+        CHECK(sut.dirty() == 0b111);
+        CHECK(sut.version<0>() == 2);
+        CHECK(sut.version<1>() == 2);
+        CHECK(sut.version<2>() == 2);
+    }
+
+    GIVEN("a Store made of shared sub-states")
+    WHEN("a reducer reports its sub-state unchanged")
+    THEN("the sub-state is not dirty")
+    {
+        auto sut = StoreFactory<MyAction>::makeShared(
+            dummyReducer,
+            [](const MyState2& state, const MyAction& action) -> std::optional<MyState2> {
+                if (action.type() == MyAction::INCREMENT) return std::nullopt;
+                return MyState2{ state.value - 1 };
+            });
+
+        sut.dispatch({ MyAction::INCREMENT });
+        CHECK(sut.dirty() == 0b01);
+        sut.dispatch({ MyAction::DECREMENT });
+        CHECK(sut.dirty() == 0b11);
+        CHECK(sut.version<0>() == 2);
+        CHECK(sut.version<1>() == 1);
+    }
+
+    GIVEN("a Store with a plain reducer")
+    WHEN("dispatching actions")
+    THEN("the whole state is versioned")
+    {
+        Store<int, MyAction> sut([](const int& state, const MyAction& action) -> std::optional<int> {
+            if (action.type() == MyAction::DECREMENT) return std::nullopt;
+            return state + 1;
+        });
+
+        sut.dispatch({ MyAction::INCREMENT });
+        CHECK(sut.dirty() == 1);
+        sut.dispatch({ MyAction::DECREMENT });
+        CHECK(sut.dirty() == 0);
+        CHECK(sut.version() == 1);
+    }
+}
@@ -1,10 +1,12 @@
 #include <ReduCxx/StoreFactory.hpp>
 #include <ReduCxx/Async/ActiveObject.hpp>
+#include <map>
 #include "../catch.hpp"
 #include <mutex>
 #include <chrono>
 #include <thread>
 #include <iostream>
+#include <string>
 
 using namespace ReduCxx;
 
@@ -80,7 +82,7 @@ SCENARIO("creation and basic features") {
             return {0, true, std::this_thread::get_id()};
         });
 
-        sut.subscribeAsync(activeObject, [&]() {
+        auto handle = sut.subscribeAsync(activeObject, [&]() {   // the subscription lasts as long as its handle
             before.get_future().wait();
             std::thread::id subscriber_thread = std::this_thread::get_id();
             REQUIRE(main_thread != subscriber_thread);
@@ -253,3 +255,680 @@ TEST_CASE("asynchronous subscriptions") {
         CHECK(handle->count() == 0);
     }
 }
+
+SCENARIO("coalesced dispatch") {
+
+    GIVEN("an async Store coalescing dispatches and a subscriber")
+    WHEN("actions are queued while the reducers thread is busy")
+    THEN("they are reduced together and the subscriber is notified once") {
+        std::promise<void> release;
+        std::shared_future<void> released = release.get_future().share();
+        std::promise<void> blocked;
+
+        auto sut = StoreFactory<int>::makeAsync(DispatchPolicy::coalesced(), [&](const int& state, const int& action) {
+            if (action == 0) {
+                blocked.set_value();
+                released.wait();
+            }
+            if (action < 0) {
+                throw std::runtime_error("negative");
+            }
+            return state + action;
+        });
+        std::vector<int> notified;
+        sut.subscribeSync([](const std::tuple<int>& state) { return std::get<0>(state); },
+                          [&](int value) { notified.push_back(value); });
+
+        std::future<void> first = sut.dispatch(0);
+        blocked.get_future().wait();                // the reducers thread is now busy
+        std::vector<std::future<void>> results;
+        for (int i = 1; i <= 10; ++i) {
+            results.push_back(sut.dispatch(i));
+        }
+        std::future<void> failing = sut.dispatch(-1);
+        std::vector<int> batch { 100, 200 };
+        std::future<void> batched = sut.dispatchBatch(batch.begin(), batch.end());
+        release.set_value();
+
+        first.get();
+        for (std::future<void>& result : results) {
+            CHECK_NOTHROW(result.get());
+        }
+        CHECK_THROWS_AS(failing.get(), std::runtime_error);
+        batched.get();
+
+        CHECK(sut.state<0>() == 355);
+        CHECK(notified == std::vector<int>{ 355 });     // the first action does not change the state
+    }
+}
+
+SCENARIO("detached dispatch") {
+
+    GIVEN("an ActiveObject with an error sink")
+    WHEN("detached jobs throw")
+    THEN("their exceptions reach the sink") {
+        ActiveObject<void> sut;
+        std::vector<std::string> errors;
+        sut.setErrorSink([&](std::exception_ptr error) {
+            try {
+                std::rethrow_exception(error);
+            } catch (const std::exception& e) {
+                errors.emplace_back(e.what());
+            }
+        });
+        int runs = 0;
+        sut.postDetached([&]() { ++runs; });
+        sut.postDetached([&]() { ++runs; throw std::runtime_error("detached"); });
+        sut.post([]() {}).get();
+
+        CHECK(runs == 2);
+        CHECK(errors == std::vector<std::string>{ "detached" });
+    }
+
+    for (bool coalesced : { false, true }) {
+        const char* given = coalesced ? "a coalescing async Store with an error sink" : "an async Store with an error sink";
+        GIVEN(given)
+        WHEN("detached dispatches throw")
+        THEN("the sink receives the exceptions of reducers and subscriptions") {
+            DispatchPolicy policy = coalesced ? DispatchPolicy::coalesced() : DispatchPolicy::sequential();
+            auto sut = StoreFactory<int>::makeAsync(policy, [](const int& state, const int& action) {
+                if (action < 0) {
+                    throw std::runtime_error("negative");
+                }
+                return state + action;
+            });
+            std::atomic<int> errors { 0 };
+            sut.setErrorSink([&](std::exception_ptr) { ++errors; });
+            sut.subscribeSync([](const std::tuple<int>& state) { return std::get<0>(state); }, [](int value) {
+                if (value == 3) {
+                    throw std::runtime_error("subscriber");
+                }
+            });
+
+            sut.dispatchDetached(1);
+            sut.dispatchDetached(-1);
+            sut.dispatchDetached(2);
+            // a synchronized dispatch could share the subscriber error in coalesced mode
+            for (int i = 0; i < 500 && errors < 2; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+
+            CHECK(sut.state<0>() == 3);
+            CHECK(errors == 2);
+        }
+    }
+}
+
+SCENARIO("priority lanes") {
+
+    GIVEN("an ActiveObject serving its lanes strictly")
+    WHEN("jobs of every priority are queued while it is busy")
+    THEN("higher lanes run first, in order within each lane") {
+        ActiveObject<void> sut;
+        std::promise<void> release;
+        std::shared_future<void> released = release.get_future().share();
+        std::promise<void> blocked;
+        sut.postDetached([&]() { blocked.set_value(); released.wait(); });
+        blocked.get_future().wait();
+
+        std::vector<std::string> order;     // only touched by the worker
+        sut.postDetached([&]() { order.push_back("low 1"); }, Priority::LOW);
+        sut.postDetached([&]() { order.push_back("normal 1"); });
+        sut.postDetached([&]() { order.push_back("normal 2"); });
+        sut.postDetached([&]() { order.push_back("high 1"); }, Priority::HIGH);
+        sut.postDetached([&]() { order.push_back("low 2"); }, Priority::LOW);
+        std::future<void> done = sut.post([&]() { order.push_back("high 2"); }, Priority::HIGH);
+        release.set_value();
+        done.get();
+        sut.post([]() {}, Priority::LOW).get();
+
+        CHECK(order == std::vector<std::string>{ "high 1", "high 2", "normal 1", "normal 2", "low 1", "low 2" });
+    }
+
+    GIVEN("an ActiveObject serving its lanes by weight")
+    WHEN("every lane has a backlog")
+    THEN("each lane gets its share of jobs and none starves") {
+        ActiveObject<void> sut(LanePolicy::weighted(3, 2, 1));
+        std::promise<void> release;
+        std::shared_future<void> released = release.get_future().share();
+        std::promise<void> blocked;
+        sut.postDetached([&]() { blocked.set_value(); released.wait(); });
+        blocked.get_future().wait();
+
+        std::string order;
+        for (int i = 0; i < 6; ++i) {
+            sut.postDetached([&]() { order += 'L'; }, Priority::LOW);
+            sut.postDetached([&]() { order += 'N'; });
+            sut.postDetached([&]() { order += 'H'; }, Priority::HIGH);
+        }
+        std::promise<void> all;
+        sut.postDetached([&]() { all.set_value(); }, Priority::LOW);
+        release.set_value();
+        all.get_future().wait();
+
+        // the blocking job spent a NORMAL credit of the first round
+        CHECK(order == "HHHNLHHHNNLNNLNLLL");
+    }
+
+    for (bool coalesced : { false, true }) {
+        const char* given = coalesced ? "a coalescing async Store with a backlog" : "an async Store with a backlog";
+        GIVEN(given)
+        WHEN("a critical action is dispatched with a high priority")
+        THEN("it is reduced before the queued actions") {
+            std::promise<void> release;
+            std::shared_future<void> released = release.get_future().share();
+            std::promise<void> blocked;
+            DispatchPolicy policy = coalesced ? DispatchPolicy::coalesced() : DispatchPolicy::sequential();
+            auto sut = StoreFactory<int>::makeAsync(policy, [&](const int& state, const int& action) {
+                if (action == 0) {
+                    blocked.set_value();
+                    released.wait();
+                    return state;
+                }
+                return action < 0 ? -state : state + action;    // halting flips the sign
+            });
+
+            sut.dispatchDetached(0);
+            blocked.get_future().wait();
+            for (int i = 0; i < 100; ++i) {
+                sut.dispatchDetached(1);
+            }
+            std::future<void> halted = sut.dispatch(-1, Priority::HIGH);
+            release.set_value();
+            halted.get();
+            sut.dispatch(1).get();
+
+            CHECK(sut.state<0>() == 101);   // the counter was still 0 when halted
+        }
+    }
+}
+
+SCENARIO("counting subscription handles") {
+
+    GIVEN("an async subscriber tracked by counters")
+    WHEN("many state changes are notified, some failing")
+    THEN("the handle counts them and keeps the last errors") {
+        ActiveObject<void> worker;
+        auto sut = StoreFactory<int>::makeAsync([](const int& state, const int& action) { return state + action; });
+        std::shared_ptr<SubscriptionHandle> handle = sut.subscribeAsync(
+            worker, TrackingPolicy::counters(4), [](const std::tuple<int>& state) { return std::get<0>(state); },
+            [](int value) {
+                if (value % 10 == 0) {
+                    throw std::runtime_error(std::to_string(value));
+                }
+            });
+        CHECK(handle->isCounting());
+
+        for (int i = 1; i < 100; ++i) {
+            sut.dispatchDetached(1);
+        }
+        sut.dispatch(1).get();
+        CHECK(handle->count() == 100);
+        handle->waitAll();
+
+        CHECK(handle->count() == 0);
+        CHECK(handle->completed() == 100);
+        CHECK(handle->failed() == 10);
+        std::vector<std::string> errors;
+        for (const std::exception_ptr& error : handle->takeErrors()) {
+            try {
+                std::rethrow_exception(error);
+            } catch (const std::exception& e) {
+                errors.emplace_back(e.what());
+            }
+        }
+        CHECK(errors == std::vector<std::string>{ "70", "80", "90", "100" });
+        CHECK(handle->takeErrors().empty());
+    }
+
+    GIVEN("a pooled async subscriber tracked by counters")
+    WHEN("waiting for its executions one by one")
+    THEN("each wait returns once an execution completed") {
+        ThreadPool pool(2);
+        auto sut = StoreFactory<int>::makeAsync([](const int& state, const int& action) { return state + action; });
+        std::promise<void> release;
+        std::shared_future<void> released = release.get_future().share();
+        std::shared_ptr<SubscriptionHandle> handle = sut.subscribeAsync(pool, TrackingPolicy::counters(), [&]() {
+            released.wait();
+        });
+
+        sut.dispatch(1).get();
+        sut.dispatch(1).get();
+        CHECK(handle->count() == 2);
+        CHECK_FALSE(handle->waitOne(std::chrono::milliseconds(10)));
+        release.set_value();
+        handle->waitOne();
+        CHECK(handle->waitOne(std::chrono::seconds(5)));
+
+        CHECK(handle->count() == 0);
+        CHECK(handle->waitAll(std::chrono::milliseconds(1)));
+    }
+
+    for (auto overflow : { QueuePolicy::Overflow::DROP_NEWEST, QueuePolicy::Overflow::DROP_OLDEST,
+                           QueuePolicy::Overflow::FAIL }) {
+        const char* given = overflow == QueuePolicy::Overflow::FAIL ? "a bounded async subscriber failing fast"
+                          : overflow == QueuePolicy::Overflow::DROP_OLDEST ? "a bounded async subscriber dropping old runs"
+                          : "a bounded async subscriber dropping new runs";
+        GIVEN(given)
+        WHEN("state changes tracked by counters are notified while it is busy")
+        THEN("the executions it drops or rejects complete with a QueueFullError") {
+            ActiveObject<void> worker(QueuePolicy::bounded(1, overflow));
+            std::promise<void> release;
+            std::shared_future<void> released = release.get_future().share();
+            std::promise<void> busy;
+            worker.postDetached([&busy, released]() { busy.set_value(); released.wait(); });
+            busy.get_future().wait();
+
+            auto sut = StoreFactory<int>::makeAsync([](const int& state, const int& action) { return state + action; });
+            std::shared_ptr<SubscriptionHandle> handle = sut.subscribeAsync(worker, TrackingPolicy::counters(), []() { });
+            for (int i = 0; i < 3; ++i) {
+                try {
+                    sut.dispatch(1).get();
+                } catch (const StoreSubscriptionsError&) {
+                    // rejected by a failing queue
+                }
+            }
+            release.set_value();
+
+            REQUIRE(handle->waitAll(std::chrono::seconds(5)));
+            CHECK(handle->completed() == 3);
+            CHECK(handle->failed() == 2);
+            CHECK(worker.rejected() == 2);
+            for (const std::exception_ptr& error : handle->takeErrors()) {
+                CHECK_THROWS_AS(std::rethrow_exception(error), QueueFullError);
+            }
+        }
+    }
+}
+
+SCENARIO("bounded queue") {
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::promise<void> blocked;
+    auto block = [&]() { blocked.set_value(); released.wait(); };
+
+    GIVEN("a full ActiveObject blocking its producers")
+    WHEN("a job is posted")
+    THEN("the producer waits for room") {
+        ActiveObject<void> sut(QueuePolicy::bounded(2, QueuePolicy::Overflow::BLOCK));
+        sut.postDetached(block);
+        blocked.get_future().wait();
+        std::atomic<int> runs { 0 };
+        sut.postDetached([&]() { ++runs; });
+        sut.postDetached([&]() { ++runs; });
+        CHECK_FALSE(sut.tryPostDetached([&]() { ++runs; }));
+
+        std::atomic<bool> posted { false };
+        std::thread producer([&]() {
+            sut.postDetached([&]() { ++runs; });
+            posted = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        CHECK_FALSE(posted);
+        release.set_value();
+        producer.join();
+        sut.post([]() {}).get();
+
+        CHECK(runs == 3);
+        CHECK(sut.rejected() == 1);
+    }
+
+    GIVEN("a full ActiveObject failing fast")
+    WHEN("jobs are posted")
+    THEN("they are rejected at once") {
+        ActiveObject<int> sut(QueuePolicy::bounded(2, QueuePolicy::Overflow::FAIL));
+        sut.postDetached([&]() { block(); return 0; });
+        blocked.get_future().wait();
+        std::future<int> first = sut.post([]() { return 1; });
+        std::optional<std::future<int>> second = sut.tryPost([]() { return 2; });
+        REQUIRE(second);
+
+        CHECK_THROWS_AS(sut.post([]() { return 3; }), QueueFullError);
+        CHECK_FALSE(sut.tryPost([]() { return 4; }));
+        std::future<int> control = sut.postUnbounded([]() { return 5; });
+        release.set_value();
+
+        CHECK(first.get() == 1);
+        CHECK(second->get() == 2);
+        CHECK(control.get() == 5);
+        CHECK(sut.rejected() == 2);
+    }
+
+    GIVEN("a full ActiveObject dropping its oldest jobs")
+    WHEN("jobs are posted")
+    THEN("the oldest of the lowest priority lane are dropped") {
+        ActiveObject<int> sut(QueuePolicy::bounded(2, QueuePolicy::Overflow::DROP_OLDEST));
+        sut.postDetached([&]() { block(); return 0; });
+        blocked.get_future().wait();
+        std::future<int> normal = sut.post([]() { return 1; });
+        std::future<int> low = sut.post([]() { return 2; }, Priority::LOW);
+        std::future<int> newest = sut.post([]() { return 3; });
+        std::future<int> newer = sut.post([]() { return 4; }, Priority::HIGH);
+        release.set_value();
+
+        CHECK_THROWS_AS(low.get(), QueueFullError);
+        CHECK_THROWS_AS(normal.get(), QueueFullError);
+        CHECK(newest.get() == 3);
+        CHECK(newer.get() == 4);
+        CHECK(sut.rejected() == 2);
+    }
+
+    GIVEN("a full ActiveObject dropping its newest jobs")
+    WHEN("jobs are posted")
+    THEN("they are dropped") {
+        ActiveObject<int> sut(QueuePolicy::bounded(2, QueuePolicy::Overflow::DROP_NEWEST));
+        sut.postDetached([&]() { block(); return 0; });
+        blocked.get_future().wait();
+        std::future<int> first = sut.post([]() { return 1; });
+        std::future<int> second = sut.post([]() { return 2; });
+        std::future<int> dropped = sut.post([]() { return 3; });
+        sut.postDetached([]() { return 4; });
+        release.set_value();
+
+        CHECK(first.get() == 1);
+        CHECK(second.get() == 2);
+        CHECK_THROWS_AS(dropped.get(), QueueFullError);
+        CHECK(sut.rejected() == 2);
+    }
+
+    GIVEN("an async Store with a bounded queue failing fast")
+    WHEN("actions are dispatched faster than reduced")
+    THEN("the extra ones are rejected") {
+        auto sut = StoreFactory<int>::makeAsync(
+            DispatchPolicy::sequential().withQueue(QueuePolicy::bounded(3, QueuePolicy::Overflow::FAIL)),
+            [&](const int& state, const int& action) {
+                if (action == 0) {
+                    block();
+                }
+                return state + action;
+            });
+        sut.dispatchDetached(0);
+        blocked.get_future().wait();
+        for (int i = 0; i < 3; ++i) {
+            sut.dispatchDetached(1);
+        }
+        CHECK_THROWS_AS(sut.dispatch(10), QueueFullError);
+        CHECK_FALSE(sut.tryDispatch(100));
+        std::future<void> posted = sut.post([]() {});
+        release.set_value();
+        posted.get();
+
+        CHECK(sut.state<0>() == 3);
+        CHECK(sut.rejected() == 2);
+    }
+}
+
+SCENARIO("snapshot reads") {
+
+    for (bool coalesced : { false, true }) {
+        const char* given = coalesced ? "a coalescing async Store and a sync subscriber reading the state" : "an async Store and a sync subscriber reading the state";
+        GIVEN(given)
+        WHEN("dispatching actions")
+        THEN("the subscriber already reads the new state") {
+            DispatchPolicy policy = coalesced ? DispatchPolicy::coalesced() : DispatchPolicy::sequential();
+            auto sut = StoreFactory<int>::makeAsync(policy, [](const int& state, const int& action) {
+                return state + action;
+            });
+            std::vector<int> seen;
+            sut.subscribeSync([&]() { seen.push_back(sut.state<0>()); });
+
+            sut.dispatch(1).get();
+            sut.dispatch(2).get();
+
+            CHECK(seen == std::vector<int>{ 1, 3 });
+        }
+    }
+
+    GIVEN("an async Store and a snapshot of its state")
+    WHEN("further actions are dispatched")
+    THEN("the snapshot is unchanged while new reads see the new state") {
+        auto sut = StoreFactory<int>::makeAsync([](const int& state, const int& action) {
+            return state + action;
+        });
+        sut.dispatch(1).get();
+        std::shared_ptr<const std::tuple<int>> before = sut.snapshot();
+        StateReader<std::tuple<int>> reader = sut.reader();
+        const std::tuple<int>* read = &reader.state();
+
+        sut.dispatch(10).get();
+
+        CHECK(std::get<0>(*before) == 1);
+        CHECK(std::get<0>(*read) == 1);
+        CHECK(std::get<0>(*sut.snapshot()) == 11);
+        CHECK(std::get<0>(reader.state()) == 11);
+        CHECK(reader.snapshot() == sut.snapshot());
+    }
+
+    GIVEN("an async Store whose reducer leaves the state unchanged")
+    WHEN("an action is dispatched")
+    THEN("no new snapshot is published") {
+        auto sut = StoreFactory<int>::makeAsync([](const int& state, const int& action) -> std::optional<int> {
+            if (action == 0) {
+                return std::nullopt;
+            }
+            return state + action;
+        });
+        std::shared_ptr<const std::tuple<int>> before = sut.snapshot();
+
+        sut.dispatch(0).get();
+
+        CHECK(sut.snapshot() == before);
+    }
+
+    GIVEN("an async Store and concurrent readers")
+    WHEN("actions are dispatched meanwhile")
+    THEN("readers only see states actually reached, in order") {
+        auto sut = StoreFactory<int>::makeAsync([](const int& state, const int& action) {
+            return state + action;
+        });
+        std::atomic<bool> done { false };
+        std::atomic<int> regressions { 0 };
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 4; ++i) {
+            readers.emplace_back([&]() {
+                StateReader<std::tuple<int>> reader = sut.reader();
+                int last = 0;
+                while (!done) {
+                    int value = std::get<0>(reader.state());
+                    if (value < last || value % 2 != 0) {
+                        ++regressions;
+                    }
+                    last = value;
+                }
+            });
+        }
+        for (int i = 0; i < 1000; ++i) {
+            sut.dispatch(2);
+        }
+        sut.dispatch(0).get();
+        done = true;
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+
+        CHECK(regressions == 0);
+        CHECK(sut.state<0>() == 2000);
+    }
+
+    GIVEN("async Stores of the same state read in turn by a thread")
+    WHEN("they are dispatched to, destroyed and built again")
+    THEN("each read sees the state of its own Store") {
+        auto append = [](const std::string& state, const char& action) { return state + action; };
+        auto first = StoreFactory<char>::makeAsync(append);
+        first.dispatch('a').get();
+        for (char c : { 'b', 'c' }) {
+            auto second = StoreFactory<char>::makeAsync(append);
+            CHECK(std::get<0>(first.state()) == "a");
+            CHECK(second.state<0>().empty());
+            second.dispatch(c).get();
+            CHECK(second.state<0>() == std::string(1, c));
+            CHECK(std::get<0>(*first.snapshot()) == "a");
+            CHECK(std::get<0>(*second.snapshot()) == std::string(1, c));
+        }
+        first.dispatch('d').get();
+        CHECK(first.state<0>() == "ad");
+    }
+}
+
+SCENARIO("seqlock reads") {
+
+    struct Counters {
+        long first = 0;
+        long second = 0;
+    };
+
+    GIVEN("an async Store of a trivially copyable state and concurrent readers")
+    WHEN("actions are dispatched meanwhile")
+    THEN("readers never see a partially written state") {
+        AsyncStore<Counters, long> sut([](const Counters& state, const long& action) -> Counters {
+            return { state.first + action, state.second + action };
+        });
+        std::atomic<bool> done { false };
+        std::atomic<int> torn { 0 };
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 4; ++i) {
+            readers.emplace_back([&]() {
+                while (!done) {
+                    Counters counters = sut.state();
+                    if (counters.first != counters.second) {
+                        ++torn;
+                    }
+                }
+            });
+        }
+        for (long i = 0; i < 1000; ++i) {
+            sut.dispatch(i);
+        }
+        sut.dispatch(0).get();
+        done = true;
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+
+        CHECK(torn == 0);
+        CHECK(sut.state().first == 999 * 1000 / 2);
+    }
+
+    GIVEN("an async Store of a composite state, with trivially copyable and other sub-states")
+    WHEN("actions are dispatched")
+    THEN("each sub-state reads the last published one") {
+        auto sut = StoreFactory<long>::makeAsync(
+            [](const Counters& state, const long& action) -> Counters {
+                return { state.first + action, state.second - action };
+            },
+            [](const std::string& state, const long& action) {
+                return state + std::to_string(action);
+            });
+
+        sut.dispatch(1).get();
+        sut.dispatch(2).get();
+
+        CHECK(sut.state<0>().first == 3);
+        CHECK(sut.state<Counters>().second == -3);
+        CHECK(sut.state<1>() == "12");
+        CHECK(std::get<0>(sut.state()).first == 3);
+    }
+}
+
+SCENARIO("sharded async store") {
+
+    struct Deposit {
+        int account;
+        long amount;
+    };
+
+    using Balances = std::map<int, long>;
+
+    auto deposit = [](Balances& state, const Deposit& action) {
+        state[action.account] += action.amount;
+    };
+    auto accountOf = [](const Deposit& action) { return action.account; };
+
+    GIVEN("a sharded async Store keyed by account")
+    WHEN("deposits are dispatched from several threads")
+    THEN("each account lives in a single shard with all its deposits") {
+        ShardedAsyncStore<Balances, Deposit> sut(deposit, accountOf, 4);
+        REQUIRE(sut.size() == 4);
+
+        std::vector<std::thread> producers;
+        for (int p = 0; p < 4; ++p) {
+            producers.emplace_back([&sut]() {
+                for (int i = 0; i < 250; ++i) {
+                    sut.dispatchDetached(Deposit { i % 10, 1 });
+                }
+            });
+        }
+        for (std::thread& producer : producers) {
+            producer.join();
+        }
+        std::vector<std::shared_ptr<const Balances>> states = sut.snapshot();
+
+        REQUIRE(states.size() == 4);
+        std::map<int, long> total;
+        for (std::size_t shard = 0; shard < states.size(); ++shard) {
+            for (const auto& [account, balance] : *states[shard]) {
+                CHECK(sut.shardOf(Deposit { account, 0 }) == shard);
+                CHECK(total.count(account) == 0);
+                total[account] = balance;
+            }
+        }
+        CHECK(total.size() == 10);
+        for (const auto& entry : total) {
+            CHECK(entry.second == 100);
+        }
+    }
+
+    GIVEN("a sharded async Store and a client depositing on two accounts in turn")
+    WHEN("taking snapshots meanwhile")
+    THEN("a deposit is never seen without the one completed before it") {
+        auto sut = StoreFactory<Deposit>::makeSharded(accountOf, 2, deposit);
+        int first = 0;
+        int second = 1;
+        while (sut.shardOf(Deposit { second, 0 }) == sut.shardOf(Deposit { first, 0 })) {
+            ++second;
+        }
+
+        std::thread client([&]() {
+            for (int i = 0; i < 200; ++i) {
+                sut.dispatch(Deposit { first, 1 }).get();
+                sut.dispatch(Deposit { second, 1 }).get();
+            }
+        });
+        int inconsistent = 0;
+        for (int i = 0; i < 50; ++i) {
+            long firsts = 0;
+            long seconds = 0;
+            for (const auto& state : sut.snapshot()) {
+                const Balances& balances = std::get<0>(*state);
+                firsts += balances.count(first) ? balances.at(first) : 0;
+                seconds += balances.count(second) ? balances.at(second) : 0;
+            }
+            inconsistent += seconds > firsts || firsts > seconds + 1;
+        }
+        client.join();
+
+        CHECK(inconsistent == 0);
+        CHECK(std::get<0>(*sut.shard(sut.shardOf(Deposit { first, 0 })).snapshot()).at(first) == 200);
+    }
+
+    GIVEN("a sharded async Store of many shards")
+    WHEN("several threads take snapshots at the same time")
+    THEN("all of them complete") {
+        ShardedAsyncStore<Balances, Deposit> sut(deposit, accountOf, 8);
+        std::atomic<int> taken { 0 };
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 4; ++r) {
+            readers.emplace_back([&sut, &taken]() {
+                for (int i = 0; i < 50; ++i) {
+                    sut.dispatchDetached(Deposit { i, 1 });
+                    taken += sut.snapshot().size() == 8;
+                }
+            });
+        }
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        CHECK(taken == 200);
+    }
+}
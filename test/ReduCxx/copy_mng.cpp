@@ -1,7 +1,135 @@
 #include <ReduCxx/Store.hpp>
+#include <ReduCxx/StoreFactory.hpp>
 #include <ReduCxx/Action.hpp>
 #include "../catch.hpp"
 
 using namespace std;
 using namespace ReduCxx;
 
+namespace {
+
+    // counts the copies made of any instance
+    struct Tracked {
+        static int copies;
+        int value = 0;
+        Tracked() = default;
+        explicit Tracked(int value) : value(value) { }
+        Tracked(const Tracked& rhs) : value(rhs.value) { ++copies; }
+        Tracked(Tracked&&) noexcept = default;
+        Tracked& operator=(const Tracked& rhs) { value = rhs.value; ++copies; return *this; }
+        Tracked& operator=(Tracked&&) noexcept = default;
+    };
+    int Tracked::copies = 0;
+
+    struct Other {
+        int value = 0;
+    };
+
+    struct Increment { };
+
+    Tracked copying(const Tracked& state, const Increment&) { return Tracked(state.value + 1); }
+
+    Tracked moving(Tracked&& state, const Increment&) { ++state.value; return std::move(state); }
+
+    void inPlace(Tracked& state, const Increment&) { ++state.value; }
+
+    Other other(const Other& state, const Increment&) { return { state.value + 1 }; }
+}
+
+SCENARIO("reducer shapes") {
+
+    GIVEN("a Store without history and a reducer consuming its state")
+    WHEN("dispatching")
+    THEN("the state is never copied") {
+        Store<Tracked, Increment> byMove(moving, HistoryPolicy::bounded(1));
+        Store<Tracked, Increment> byRef(inPlace, HistoryPolicy::bounded(1));
+        Tracked::copies = 0;
+        for (int i = 0; i < 10; ++i) {
+            byMove.dispatch({});
+            byRef.dispatch({});
+        }
+        CHECK(byMove.state().value == 10);
+        CHECK(byRef.state().value == 10);
+        CHECK(Tracked::copies == 0);
+    }
+
+    GIVEN("a Store with history and a reducer consuming its state")
+    WHEN("dispatching and reverting")
+    THEN("previous states are copied and preserved") {
+        Store<Tracked, Increment> byMove(moving);
+        Store<Tracked, Increment> byRef(inPlace, HistoryPolicy::bounded(4));
+        Tracked::copies = 0;
+        byMove.dispatch({});
+        byMove.dispatch({});
+        byRef.dispatch({});
+        byRef.dispatch({});
+        CHECK(Tracked::copies == 4);
+        CHECK(byMove.revert());
+        CHECK(byRef.revert());
+        CHECK(byMove.state().value == 1);
+        CHECK(byRef.state().value == 1);
+    }
+
+    GIVEN("a composite Store mixing every reducer shape")
+    WHEN("dispatching without history")
+    THEN("only the copying reducer copies") {
+        auto sut = StoreFactory<Increment>::make(HistoryPolicy::bounded(1), copying, moving, inPlace, other);
+        Tracked::copies = 0;
+        sut.dispatch({});
+        sut.dispatch({});
+        CHECK(sut.state<0>().value == 2);
+        CHECK(sut.state<1>().value == 2);
+        CHECK(sut.state<2>().value == 2);
+        CHECK(sut.state<3>().value == 2);
+        CHECK(Tracked::copies == 0);   // copying() builds a new instance from the value
+    }
+
+    GIVEN("a composite Store with history mixing every reducer shape")
+    WHEN("a reducer throws")
+    THEN("the whole state is left unchanged") {
+        auto sut = StoreFactory<Increment>::make(moving, inPlace,
+            [](const Other& state, const Increment&) -> Other {
+                if (state.value == 1) throw "error";
+                return { state.value + 1 };
+            });
+        sut.dispatch({});
+        CHECK_THROWS(sut.dispatch({}));
+        CHECK(sut.state<0>().value == 1);
+        CHECK(sut.state<1>().value == 1);
+        CHECK(sut.state<2>().value == 1);
+    }
+
+    GIVEN("a routed composite Store of consuming reducers")
+    WHEN("dispatching without history")
+    THEN("the state is never copied") {
+        struct Event : public Action {
+            int type() const override { return 0; }
+        };
+        auto sut = StoreFactory<Event>::make(HistoryPolicy::bounded(1),
+            handles<0>([](Tracked&& state, const Event&) { ++state.value; return std::move(state); }),
+            handles<1>([](Tracked& state, const Event&) { ++state.value; }));
+        Tracked::copies = 0;
+        sut.dispatch({});
+        CHECK(sut.state<0>().value == 1);
+        CHECK(sut.state<1>().value == 0);
+        CHECK(Tracked::copies == 0);
+    }
+
+    GIVEN("a composite Store without history whose second reducer throws")
+    WHEN("dispatching, routed or not")
+    THEN("the sub-state of the first one is left unchanged") {
+        struct Event : public Action {
+            int type() const override { return 0; }
+        };
+        auto plain = StoreFactory<Event>::make(HistoryPolicy::bounded(1),
+            [](const Other& state, const Event&) -> Other { return { state.value + 1 }; },
+            [](const Tracked&, const Event&) -> Tracked { throw "error"; });
+        auto routed = StoreFactory<Event>::make(HistoryPolicy::bounded(1),
+            handles<0>([](const Other& state, const Event&) -> Other { return { state.value + 1 }; }),
+            handles<0>([](const Tracked&, const Event&) -> Tracked { throw "error"; }));
+        CHECK_THROWS(plain.dispatch({}));
+        CHECK_THROWS(routed.dispatch({}));
+        CHECK(plain.state<0>().value == 0);
+        CHECK(routed.state<0>().value == 0);
+    }
+}
@@ -0,0 +1,212 @@
+#include <ReduCxx/StoreFactory.hpp>
+#include "../catch.hpp"
+#include <vector>
+
+using namespace ReduCxx;
+
+SCENARIO("history retention")
+{
+    struct MyState
+    {
+        int value;
+    };
+
+    struct MyAction
+    {
+        int delta;
+    };
+
+    auto reducer = [](const MyState& state, const MyAction& action) -> MyState {
+        return { state.value + action.delta };
+    };
+
+    GIVEN("a Store with an unbounded history")
+    WHEN("reverting more actions than the initial capacity")
+    THEN("every state is rolled-back in order")
+    {
+        Store<MyState, MyAction> sut(reducer);
+        for (int i = 1; i <= 100; ++i)
+        {
+            sut.dispatch({ 1 });
+        }
+        CHECK(sut.state().value == 100);
+        for (int i = 99; i >= 0; --i)
+        {
+            REQUIRE(sut.revert());
+            REQUIRE(sut.state().value == i);
+        }
+        CHECK(!sut.revert());
+    }
+
+    GIVEN("a Store with a bounded history")
+    WHEN("dispatching more actions than its depth")
+    THEN("only the most recent states can be reverted")
+    {
+        Store<MyState, MyAction> sut(reducer, HistoryPolicy::bounded(3));
+        for (int i = 1; i <= 10; ++i)
+        {
+            sut.dispatch({ 1 });
+        }
+        CHECK(sut.state().value == 10);
+        CHECK(sut.revert());
+        CHECK(sut.state().value == 9);
+        CHECK(sut.revert());
+        CHECK(sut.state().value == 8);
+        CHECK(!sut.revert());
+        CHECK(sut.state().value == 8);
+
+        sut.dispatch({ 5 });
+        CHECK(sut.state().value == 13);
+        CHECK(sut.revert());
+        CHECK(sut.state().value == 8);
+    }
+
+    GIVEN("a Store with no history")
+    WHEN("reverting")
+    THEN("nothing happens")
+    {
+        Store<MyState, MyAction> none(reducer, HistoryPolicy::bounded(0));
+        Store<MyState, MyAction> one(reducer, HistoryPolicy::bounded(1));
+        none.dispatch({ 1 });
+        one.dispatch({ 1 });
+        CHECK(!none.revert());
+        CHECK(!one.revert());
+        CHECK(none.state().value == 1);
+        CHECK(one.state().value == 1);
+    }
+
+    GIVEN("a Store with a bounded history")
+    WHEN("dispatching a batch of actions")
+    THEN("the whole batch is reverted at once")
+    {
+        Store<MyState, MyAction> sut(reducer, HistoryPolicy::bounded(3));
+        std::vector<MyAction> batch { { 1 }, { 2 }, { 3 } };
+        sut.dispatch({ 10 });
+        sut.dispatchBatch(batch.begin(), batch.end());
+        CHECK(sut.state().value == 16);
+        CHECK(sut.revert());
+        CHECK(sut.state().value == 10);
+    }
+
+    GIVEN("a composite Store built with a history policy")
+    WHEN("reverting beyond its depth")
+    THEN("the revert is refused")
+    {
+        auto sut = StoreFactory<MyAction>::make(HistoryPolicy::bounded(2), reducer);
+        sut.dispatch({ 1 });
+        sut.dispatch({ 1 });
+        CHECK(sut.revert());
+        CHECK(!sut.revert());
+        CHECK(sut.state<0>().value == 1);
+    }
+}
+
+SCENARIO("event-sourced history")
+{
+    struct MyState
+    {
+        long value;
+    };
+
+    struct MyAction
+    {
+        long delta;
+    };
+
+    int calls = 0;
+    auto reducer = [&](const MyState& state, const MyAction& action) -> MyState {
+        ++calls;
+        return { state.value * 2 + action.delta };
+    };
+
+    GIVEN("a Store with an event-sourced history")
+    WHEN("reverting")
+    THEN("previous states are rebuilt from the closest snapshot")
+    {
+        Store<MyState, MyAction> sut(reducer, HistoryPolicy::eventSourced(4));
+        std::vector<long> expected { 0 };
+        for (long i = 1; i <= 10; ++i)
+        {
+            sut.dispatch({ i });
+            expected.push_back(expected.back() * 2 + i);
+        }
+        CHECK(sut.state().value == expected[10]);
+
+        calls = 0;
+        CHECK(sut.revert());            // 9 is replayed from the snapshot at 8
+        CHECK(sut.state().value == expected[9]);
+        CHECK(calls == 1);
+        CHECK(sut.revert());
+        CHECK(sut.state().value == expected[8]);
+        CHECK(calls == 1);
+
+        for (long i = 8; i > 0; --i)
+        {
+            REQUIRE(sut.revert());
+            REQUIRE(sut.state().value == expected[i - 1]);
+        }
+        CHECK(!sut.revert());
+        CHECK(sut.state().value == 0);
+    }
+
+    GIVEN("a Store with an event-sourced history")
+    WHEN("reverting batches of actions")
+    THEN("each batch is replayed and reverted as a whole")
+    {
+        Store<MyState, MyAction> sut(reducer, HistoryPolicy::eventSourced(2, 4));
+        std::vector<long> expected { 0 };
+        std::vector<MyAction> batch;
+        for (long i = 1; i <= 6; ++i)
+        {
+            batch.assign({ { i }, { -i } });
+            sut.dispatchBatch(batch.begin(), batch.end());
+            expected.push_back(expected.back() * 4 + i);
+        }
+        CHECK(sut.state().value == expected[6]);
+
+        for (long i = 5; i >= 3; --i)
+        {
+            REQUIRE(sut.revert());
+            REQUIRE(sut.state().value == expected[i]);
+        }
+        CHECK(!sut.revert());
+    }
+
+    GIVEN("a Store with a bounded event-sourced history")
+    WHEN("reverting beyond its depth")
+    THEN("the revert is refused as for a bounded history")
+    {
+        Store<MyState, MyAction> sut(reducer, HistoryPolicy::eventSourced(2, 3));
+        for (long i = 1; i <= 10; ++i)
+        {
+            sut.dispatch({ 1 });
+        }
+        long current = sut.state().value;
+        CHECK(sut.revert());
+        CHECK(sut.state().value == (current - 1) / 2);
+        CHECK(sut.revert());
+        CHECK(!sut.revert());
+
+        sut.dispatch({ 0 });
+        CHECK(sut.revert());
+        CHECK(!sut.revert());
+    }
+
+    GIVEN("a Store with an event-sourced history")
+    WHEN("a reducer throws")
+    THEN("the action is not recorded")
+    {
+        Store<MyState, MyAction> sut([](const MyState& state, const MyAction& action) -> MyState {
+            if (action.delta < 0) throw "error";
+            return { state.value + action.delta };
+        }, HistoryPolicy::eventSourced(3));
+        sut.dispatch({ 1 });
+        CHECK_THROWS(sut.dispatch({ -1 }));
+        sut.dispatch({ 2 });
+        CHECK(sut.revert());
+        CHECK(sut.state().value == 1);
+        CHECK(sut.revert());
+        CHECK(sut.state().value == 0);
+        CHECK(!sut.revert());
+    }
+}
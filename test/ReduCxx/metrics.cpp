@@ -0,0 +1,141 @@
+#include <ReduCxx/StoreFactory.hpp>
+#include <ReduCxx/Async/ShardedAsyncStore.hpp>
+#include "../catch.hpp"
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <thread>
+#include <vector>
+
+using namespace ReduCxx;
+using std::chrono::nanoseconds;
+
+SCENARIO("latency histograms") {
+
+    GIVEN("the buckets of a latency histogram")
+    WHEN("latencies of any magnitude are counted")
+    THEN("each one falls in a bucket ending within 1/16 above it") {
+        for (std::uint64_t ns : { 0ull, 1ull, 15ull, 16ull, 17ull, 31ull, 32ull, 1000ull, 123456789ull, ~0ull >> 1 }) {
+            const std::size_t bucket = LatencyHistogram::bucketOf(ns);
+            REQUIRE(bucket < LatencyHistogram::BUCKETS);
+            CHECK(LatencyHistogram::highestOf(bucket) >= ns);
+            CHECK(LatencyHistogram::highestOf(bucket) - ns <= ns / 16);
+            if (bucket > 0) {
+                CHECK(LatencyHistogram::highestOf(bucket - 1) < ns);
+            }
+        }
+        CHECK(LatencyHistogram::bucketOf(~0ull) == LatencyHistogram::BUCKETS - 1);
+    }
+
+    GIVEN("a recording histogram")
+    WHEN("latencies are recorded")
+    THEN("its snapshot reports their count, mean, maximum and percentiles") {
+        _impl::AtomicHistogram sut;
+        CHECK(sut.snapshot().count() == 0);
+        CHECK(sut.snapshot().percentile(99) == nanoseconds(0));
+
+        for (int i = 1; i <= 100; ++i) {
+            sut.record(nanoseconds(i * 1000));
+        }
+        sut.record(nanoseconds(-5));    // clock skew counts as no time
+
+        LatencyHistogram histogram = sut.snapshot();
+        CHECK(histogram.count() == 101);
+        CHECK(histogram.max() == nanoseconds(100000));
+        CHECK(histogram.mean() == nanoseconds(50500 * 100 / 101));
+        CHECK(histogram.percentile(0) == nanoseconds(0));
+        CHECK(histogram.percentile(50) >= nanoseconds(50000));
+        CHECK(histogram.percentile(50) <= nanoseconds(50000 + 50000 / 16));
+        CHECK(histogram.percentile(100) == nanoseconds(100000));
+
+        histogram += sut.snapshot();
+        CHECK(histogram.count() == 202);
+        CHECK(histogram.max() == nanoseconds(100000));
+    }
+}
+
+SCENARIO("dispatch metrics") {
+
+    GIVEN("an async Store whose reducer is held")
+    WHEN("actions are queued behind it")
+    THEN("the depth of the queue and its high-water mark are reported") {
+        std::promise<void> hold;
+        std::shared_future<void> held = hold.get_future().share();
+        auto sut = StoreFactory<int>::makeAsync([held](const int& state, const int& action) {
+            held.wait();
+            return state + action;
+        });
+        CHECK(sut.metrics().queue.highWater == 0);
+
+        std::vector<std::future<void>> done;
+        for (int i = 0; i < 11; ++i) {
+            done.push_back(sut.dispatch(1));
+        }
+        // the first one is running once the depth is down to 10
+        for (int i = 0; i < 500 && sut.metrics().queue.depth > 10; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        CHECK(sut.metrics().queue.depth == 10);
+        CHECK(sut.metrics().queue.highWater >= 10);
+
+        hold.set_value();
+        for (std::future<void>& one : done) {
+            one.get();
+        }
+        const DispatchMetrics metrics = sut.metrics();
+        CHECK(metrics.queue.depth == 0);
+        CHECK(metrics.queue.highWater >= 10);
+        CHECK(metrics.total.count() == 11);     // recorded before the futures are ready
+        CHECK(metrics.queueWait.count() == 11);
+        CHECK(metrics.reduce.count() == 11);
+        CHECK(metrics.subscriptions.count() == 11);
+        CHECK(metrics.total.max() >= metrics.reduce.max());
+        CHECK(metrics.total.max() >= metrics.queueWait.max());
+    }
+
+    for (bool coalesced : { false, true }) {
+        const char* given = coalesced ? "a coalescing async Store and a slow subscriber"
+                                      : "an async Store and a slow subscriber";
+        GIVEN(given)
+        WHEN("actions are dispatched, some of them failing")
+        THEN("the latencies of the ones completed are recorded, subscriptions included") {
+            DispatchPolicy policy = coalesced ? DispatchPolicy::coalesced() : DispatchPolicy::sequential();
+            auto sut = StoreFactory<int>::makeAsync(policy, [](const int& state, const int& action) {
+                if (action < 0) {
+                    throw std::runtime_error("negative");
+                }
+                return state + action;
+            });
+            sut.subscribeSync([]() { std::this_thread::sleep_for(std::chrono::milliseconds(2)); });
+
+            sut.dispatchDetached(1);
+            CHECK_THROWS(sut.dispatch(-1).get());
+            sut.dispatch(2).get();
+            std::vector<int> batch { 1, 2, 3 };
+            sut.dispatchBatch(batch.begin(), batch.end()).get();
+
+            const DispatchMetrics metrics = sut.metrics();
+            CHECK(metrics.total.count() == 3);
+            CHECK(metrics.subscriptions.count() == 3);
+            CHECK(metrics.subscriptions.max() >= std::chrono::milliseconds(2));
+            CHECK(metrics.total.percentile(50) >= std::chrono::milliseconds(2));
+        }
+    }
+
+    GIVEN("a sharded async Store")
+    WHEN("actions are dispatched to all the shards")
+    THEN("the metrics of the shards are merged") {
+        using Balances = std::map<int, long>;
+        ShardedAsyncStore<Balances, int> sut([](Balances& state, const int& account) { ++state[account]; },
+                                             [](const int& account) { return account; }, 3);
+        for (int account = 0; account < 30; ++account) {
+            sut.dispatch(account).get();
+        }
+        const DispatchMetrics metrics = sut.metrics();
+        CHECK(metrics.total.count() == 30);
+        CHECK(metrics.reduce.count() == 30);
+        CHECK(metrics.queue.depth == 0);
+        CHECK(metrics.queue.highWater >= 1);
+    }
+}
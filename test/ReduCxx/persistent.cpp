@@ -0,0 +1,159 @@
+#include <ReduCxx/Store.hpp>
+#include <ReduCxx/Persistent/PersistentVector.hpp>
+#include <ReduCxx/Persistent/PersistentMap.hpp>
+#include "../catch.hpp"
+#include <string>
+
+using namespace ReduCxx;
+
+SCENARIO("persistent vector") {
+
+    GIVEN("a persistent vector spanning several trie levels")
+    WHEN("appending, replacing and removing elements")
+    THEN("every version keeps its own content") {
+        const int COUNT = 40000;
+        PersistentVector<int> sut;
+        std::vector<PersistentVector<int>> versions;
+        for (int i = 0; i < COUNT; ++i) {
+            sut = sut.push_back(i);
+            if (i % 1000 == 0) versions.push_back(sut);
+        }
+        REQUIRE(sut.size() == COUNT);
+        for (int i = 0; i < COUNT; ++i) {
+            REQUIRE(sut[i] == i);
+        }
+        for (std::size_t v = 0; v < versions.size(); ++v) {
+            REQUIRE(versions[v].size() == v * 1000 + 1);
+            REQUIRE(versions[v].back() == int(v * 1000));
+        }
+
+        auto changed = sut.set(12345, -1).set(COUNT - 1, -2);
+        CHECK(changed[12345] == -1);
+        CHECK(changed.back() == -2);
+        CHECK(sut[12345] == 12345);
+        CHECK(sut.back() == COUNT - 1);
+        CHECK(changed != sut);
+
+        auto shrunk = sut;
+        for (int i = COUNT - 1; i >= 0; --i) {
+            REQUIRE(shrunk.back() == i);
+            shrunk = shrunk.pop_back();
+        }
+        CHECK(shrunk.empty());
+        CHECK(sut.size() == COUNT);
+        CHECK_THROWS_AS(sut.at(COUNT), std::out_of_range);
+    }
+
+    GIVEN("two persistent vectors")
+    WHEN("comparing and iterating")
+    THEN("they behave as regular containers") {
+        PersistentVector<std::string> a { "a", "b", "c" };
+        PersistentVector<std::string> b = PersistentVector<std::string>().push_back("a").push_back("b").push_back("c");
+        PersistentVector<std::string> copy = a;
+        CHECK(a == b);
+        CHECK(!a.identical(b));
+        CHECK(a.identical(copy));
+
+        std::string joined;
+        for (const std::string& s : a) joined += s;
+        CHECK(joined == "abc");
+        CHECK(a.end() - a.begin() == 3);
+        CHECK(a.update(1, [](const std::string& s) { return s + s; })[1] == "bb");
+    }
+}
+
+namespace {
+    // poor hash, forces collisions and deep tries
+    struct BadHash {
+        std::size_t operator()(int key) const { return std::size_t(key % 7); }
+    };
+}
+
+SCENARIO("persistent map") {
+
+    GIVEN("a persistent map with many keys")
+    WHEN("inserting, updating and erasing")
+    THEN("every version keeps its own content") {
+        const int COUNT = 20000;
+        PersistentMap<int, int> sut;
+        for (int i = 0; i < COUNT; ++i) {
+            sut = sut.set(i, i * 2);
+        }
+        REQUIRE(sut.size() == COUNT);
+        for (int i = 0; i < COUNT; ++i) {
+            REQUIRE(sut.at(i) == i * 2);
+        }
+        CHECK(sut.find(COUNT) == nullptr);
+        CHECK_THROWS_AS(sut.at(-1), std::out_of_range);
+
+        auto updated = sut.set(7, -7).update(8, [](int v) { return v + 1; });
+        CHECK(updated.size() == COUNT);
+        CHECK(updated.at(7) == -7);
+        CHECK(updated.at(8) == 17);
+        CHECK(sut.at(7) == 14);
+
+        auto erased = sut;
+        for (int i = 0; i < COUNT; i += 2) {
+            erased = erased.erase(i);
+        }
+        CHECK(erased.size() == COUNT / 2);
+        CHECK(!erased.contains(0));
+        CHECK(erased.contains(1));
+        CHECK(erased.erase(0).identical(erased));
+        CHECK(sut.size() == COUNT);
+
+        std::size_t visited = 0;
+        long sum = 0;
+        for (const auto& entry : erased) {
+            ++visited;
+            sum += entry.second - entry.first * 2;
+        }
+        CHECK(visited == erased.size());
+        CHECK(sum == 0);
+    }
+
+    GIVEN("a persistent map with colliding hashes")
+    WHEN("inserting and erasing")
+    THEN("colliding keys are kept apart") {
+        PersistentMap<int, std::string, BadHash> sut { {1, "one"}, {8, "eight"}, {15, "fifteen"}, {2, "two"} };
+        CHECK(sut.size() == 4);
+        CHECK(sut.at(8) == "eight");
+        auto less = sut.erase(8);
+        CHECK(less.size() == 3);
+        CHECK(!less.contains(8));
+        CHECK(less.at(1) == "one");
+        CHECK(less.at(15) == "fifteen");
+        CHECK(less == less.set(2, "two"));
+        CHECK(less != sut);
+        CHECK(less.erase(1).erase(15).erase(2).empty());
+    }
+}
+
+SCENARIO("persistent containers as state") {
+
+    struct State {
+        PersistentVector<int> values;
+    };
+    struct Set { std::size_t index; int value; };
+
+    GIVEN("a Store holding a persistent vector")
+    WHEN("reverting")
+    THEN("history entries share the untouched data") {
+        Store<State, Set> sut([](const State& state, const Set& action) -> State {
+            if (state.values.empty()) {
+                PersistentVector<int> values;
+                for (int i = 0; i < 1000; ++i) values = values.push_back(0);
+                return { values.set(action.index, action.value) };
+            }
+            return { state.values.set(action.index, action.value) };
+        });
+
+        sut.dispatch({ 10, 1 });
+        sut.dispatch({ 500, 2 });
+        CHECK(sut.state().values[10] == 1);
+        CHECK(sut.state().values[500] == 2);
+        CHECK(sut.revert());
+        CHECK(sut.state().values[10] == 1);
+        CHECK(sut.state().values[500] == 0);
+    }
+}
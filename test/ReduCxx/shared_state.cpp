@@ -0,0 +1,86 @@
+#include <ReduCxx/StoreFactory.hpp>
+#include "../catch.hpp"
+#include <optional>
+#include <vector>
+
+using namespace ReduCxx;
+
+namespace {
+
+    struct Add { int key; int value; };
+
+    struct Counter {
+        int value = 0;
+        bool operator==(const Counter& rhs) const { return value == rhs.value; }
+    };
+
+    struct Bag {
+        std::vector<int> values;
+    };
+
+    // touched by every action
+    Counter count(const Counter& state, const Add&) {
+        return { state.value + 1 };
+    }
+
+    // touched only by actions for key 0
+    std::optional<Bag> bag0(const Bag& state, const Add& action) {
+        if (action.key != 0) return std::nullopt;
+        Bag next = state;
+        next.values.push_back(action.value);
+        return next;
+    }
+}
+
+SCENARIO("shared sub-states") {
+
+    GIVEN("a Store made of shared sub-states")
+    WHEN("a reducer reports its sub-state as unchanged")
+    THEN("the very same box is kept, the others are replaced") {
+        int copies = 0;
+        auto sut = StoreFactory<Add>::makeShared(
+            count,
+            bag0,
+            [&](const Bag& state, const Add& action) -> std::optional<Bag> {
+                if (action.key != 1) return std::nullopt;
+                ++copies;
+                Bag next = state;
+                next.values.push_back(action.value);
+                return next;
+            });
+
+        Shared<Counter> counter = sut.state<0>();
+        Shared<Bag> first = sut.state<1>();
+        Shared<Bag> second = sut.state<2>();
+
+        sut.dispatch({ 0, 42 });
+        CHECK(sut.state<0>()->value == 1);
+        CHECK(!sut.state<0>().identical(counter));
+        CHECK(!sut.state<1>().identical(first));
+        CHECK(sut.state<1>()->values == std::vector<int> { 42 });
+        CHECK(sut.state<2>().identical(second));
+        CHECK(copies == 0);
+
+        first = sut.state<1>();
+        sut.dispatch({ 1, 7 });
+        CHECK(sut.state<1>().identical(first));
+        CHECK(sut.state<2>()->values == std::vector<int> { 7 });
+        CHECK(copies == 1);
+
+        CHECK(sut.revert());
+        CHECK(sut.state<1>().identical(first));
+        CHECK(sut.state<2>()->values.empty());
+    }
+
+    GIVEN("two shared boxes")
+    WHEN("comparing")
+    THEN("the content is compared unless they are the same instance") {
+        Shared<Counter> a(Counter { 1 });
+        Shared<Counter> b(Counter { 1 });
+        Shared<Counter> c = a;
+        CHECK(a == b);
+        CHECK(!a.identical(b));
+        CHECK(a.identical(c));
+        CHECK(a != Shared<Counter>(Counter { 2 }));
+    }
+}
@@ -1,6 +1,13 @@
 #include <ReduCxx/Store.hpp>
 #include <ReduCxx/Action.hpp>
+#include <ReduCxx/Async/AsyncStore.hpp>
+#include <ReduCxx/StoreFactory.hpp>
 #include "../catch.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
 #include <vector>
 
 using namespace std;
@@ -42,5 +49,247 @@ SCENARIO("subscriptions") {
         CHECK(called);
     }
 
- 
+    GIVEN("a Store and a subscriber")
+    WHEN("a batch of events is dispatched")
+    THEN("the subscriber is called once, after the whole batch") {
+        std::vector<int> seen;
+        sut.subscribe([&]() { seen.push_back(sut.state().value); });
+
+        std::vector<MyAction> batch { MyAction::INCREMENT, MyAction::INCREMENT, MyAction::DECREMENT, MyAction::INCREMENT };
+        sut.dispatchBatch(batch.begin(), batch.end());
+        sut.dispatchBatch(batch.end(), batch.end());
+        CHECK(seen == vector<int>{ 2 });
+    }
+
+    GIVEN("a Store and a subscriber")
+    WHEN("a reducer throws within a batch")
+    THEN("neither the state changes nor the subscriber is called") {
+        bool called = false;
+        Store<MyState, int> sut([](const MyState& state, int action) -> MyState {
+            if (action < 0) throw "error";
+            return { state.value + action };
+        });
+        sut.subscribe([&]() { called = true; });
+
+        std::vector<int> batch { 1, 2, -1, 3 };
+        CHECK_THROWS(sut.dispatchBatch(batch.begin(), batch.end()));
+        CHECK(sut.state().value == 0);
+        CHECK(!called);
+    }
+
+    GIVEN("a Store and a subscriber to a slice of the state")
+    WHEN("events are dispatched")
+    THEN("the subscriber is called only when the slice changes") {
+        std::vector<int> seen;
+        sut.subscribe([](const MyState& state) { return state.value / 2; },
+                      [&](int half) { seen.push_back(half); });
+
+        sut.dispatch( {MyAction::INCREMENT } );     // 1 -> 0, unchanged
+        CHECK(seen.empty());
+        sut.dispatch( {MyAction::INCREMENT } );     // 2 -> 1
+        sut.dispatch( {MyAction::INCREMENT } );     // 3 -> 1, unchanged
+        sut.dispatch( {MyAction::DECREMENT } );     // 2 -> 1, unchanged
+        sut.dispatch( {MyAction::DECREMENT } );     // 1 -> 0
+        CHECK(seen == vector<int>{ 1, 0 });
+    }
+
+    GIVEN("a Store and a slice subscriber with a custom comparison")
+    WHEN("events are dispatched")
+    THEN("the comparison decides what a change is") {
+        int calls = 0;
+        sut.subscribe([](const MyState& state) { return state.value; },
+                      [&](int) { ++calls; },
+                      [](int last, int current) { return current - last < 2; });
+
+        sut.dispatch( {MyAction::INCREMENT } );
+        CHECK(calls == 0);
+        sut.dispatch( {MyAction::INCREMENT } );
+        CHECK(calls == 1);
+    }
+}
+
+SCENARIO("subscriptions added by subscriptions") {
+
+    Store<int, int> sut([](const int& state, const int& action) { return state + action; });
+    std::vector<std::string> calls;
+
+    GIVEN("a subscriber subscribing more callbacks than its Store holds yet")
+    WHEN("a state change runs it")
+    THEN("it is still intact afterwards, the new callbacks being called from the next change on") {
+        const std::string name = "a name too long to be stored inline by std::string";
+        bool subscribed = false;
+        sut.subscribe([&, name]() {
+            if (!subscribed) {
+                subscribed = true;
+                for (int i = 0; i < 8; ++i) {
+                    sut.subscribe([&]() { calls.push_back("added"); });
+                }
+            }
+            calls.push_back(name);     // reads its own capture
+        });
+
+        sut.dispatch(1);
+        CHECK(calls == vector<std::string>{ name });
+
+        calls.clear();
+        sut.dispatch(1);
+        REQUIRE(calls.size() == 9);
+        CHECK(calls.front() == name);
+        CHECK(std::count(calls.begin(), calls.end(), "added") == 8);
+    }
+}
+
+SCENARIO("unsubscriptions") {
+
+    Store<int, int> sut([](const int& state, const int& action) { return state + action; });
+    std::vector<std::string> calls;
+
+    GIVEN("a Store and some subscribers")
+    WHEN("one of them is unsubscribed")
+    THEN("the other ones are still called") {
+        Subscription first = sut.subscribe([&]() { calls.push_back("first"); });
+        Subscription second = sut.subscribe([&]() { calls.push_back("second"); });
+        sut.subscribe([&]() { calls.push_back("third"); });
+
+        CHECK(sut.unsubscribe(first));
+        CHECK_FALSE(sut.unsubscribe(first));
+        CHECK_FALSE(sut.unsubscribe(Subscription()));
+        sut.dispatch(1);
+        CHECK(calls == vector<std::string>{ "second", "third" });
+
+        Subscription fourth = sut.subscribe([&]() { calls.push_back("fourth"); });
+        CHECK(fourth.index == first.index);     // slot reused, but not the token
+        CHECK(fourth != first);
+        CHECK_FALSE(sut.unsubscribe(first));
+        CHECK(sut.unsubscribe(second));
+        calls.clear();
+        sut.dispatch(1);
+        CHECK(calls == vector<std::string>{ "fourth", "third" });  // in the place of the removed one
+    }
+
+    GIVEN("a Store and some subscribers")
+    WHEN("a subscriber unsubscribes itself and a later one")
+    THEN("neither is called afterwards") {
+        Subscription self;
+        Subscription later;
+        self = sut.subscribe([&]() {
+            calls.push_back("self");
+            CHECK(sut.unsubscribe(self));
+            CHECK(sut.unsubscribe(later));
+            CHECK_FALSE(sut.unsubscribe(later));
+        });
+        later = sut.subscribe([&]() { calls.push_back("later"); });
+        sut.subscribe([&]() { calls.push_back("other"); });
+
+        sut.dispatch(1);
+        sut.dispatch(1);
+        CHECK(calls == vector<std::string>{ "self", "other", "other" });
+    }
+
+    GIVEN("a subscription tied to an owner")
+    WHEN("the owner expires")
+    THEN("the subscription is removed at the next state change") {
+        auto owner = std::make_shared<int>(0);
+        Subscription tied = sut.subscribe([&]() { calls.push_back("tied"); });
+        CHECK(sut.tie(tied, owner));
+
+        sut.dispatch(1);
+        owner.reset();
+        sut.dispatch(1);
+        CHECK(calls == vector<std::string>{ "tied" });
+        CHECK_FALSE(sut.unsubscribe(tied));
+    }
+
+    GIVEN("an AsyncStore and subscribers")
+    WHEN("a synchronous one is unsubscribed and the handle of an asynchronous one released")
+    THEN("they are not run anymore") {
+        auto async = StoreFactory<int>::makeAsync([](const int& state, const int& action) { return state + action; });
+        ActiveObject<void> worker;
+        std::atomic<int> sync { 0 };
+        std::atomic<int> posted { 0 };
+        Subscription token = async.subscribeSync([&]() { ++sync; });
+        std::shared_ptr<SubscriptionHandle> handle = async.subscribeAsync(worker, [&]() { ++posted; });
+
+        async.dispatch(1).get();
+        handle->waitAll();
+        CHECK(async.unsubscribe(token));
+        handle.reset();
+        async.dispatch(1).get();
+        async.dispatch(1).get();
+        worker.post([]() {}).get();
+
+        CHECK(sync == 1);
+        CHECK(posted == 1);
+    }
+
+    GIVEN("an AsyncStore dispatching actions")
+    WHEN("callbacks are subscribed and unsubscribed meanwhile, by other threads and by subscriptions")
+    THEN("nothing deadlocks and every subscription sees the later changes") {
+        auto async = StoreFactory<int>::makeAsync([](const int& state, const int& action) { return state + action; });
+        std::atomic<int> nested { 0 };
+        Subscription outer;
+        outer = async.subscribeSync([&]() {
+            async.unsubscribe(outer);
+            async.subscribeSync([&]() { ++nested; });
+        });
+        std::thread producer([&]() {
+            for (int i = 0; i < 200; ++i) {
+                async.dispatchDetached(1);
+            }
+        });
+        std::atomic<int> later { 0 };
+        for (int i = 0; i < 50; ++i) {
+            CHECK(async.unsubscribe(async.subscribeSync([&]() { ++later; })));
+        }
+        async.subscribeSync([&]() { ++later; });
+        producer.join();
+        async.post([&]() { CHECK_FALSE(async.unsubscribe(outer)); }).get();    // removed by itself
+        async.dispatch(1).get();
+
+        CHECK(nested >= 1);
+        CHECK(later >= 1);
+    }
+}
+
+SCENARIO("slice subscriptions on async stores") {
+
+    struct MyState {
+        int value;
+        int other;
+    };
+
+    AsyncStore<MyState, int> sut([](const MyState& state, int action) -> MyState {
+        return action > 0 ? MyState{ state.value + action, state.other } : MyState{ state.value, state.other + 1 };
+    });
+
+    GIVEN("an AsyncStore and a slice subscriber on an active object")
+    WHEN("events touching other slices are dispatched")
+    THEN("nothing is posted to the subscriber") {
+        ActiveObject<void> worker;
+        std::vector<int> seen;
+        std::shared_ptr<SubscriptionHandle> handle = sut.subscribeAsync(
+            worker, [](const MyState& state) { return state.value; }, [&](int value) { seen.push_back(value); });
+
+        sut.dispatch(0);
+        sut.dispatch(2);
+        sut.dispatch(0);
+        sut.dispatch(0);
+        sut.dispatch(3).get();
+        worker.post([]() {}).get();     // drain the subscriber queue
+
+        CHECK(seen == vector<int>{ 2, 5 });
+        CHECK(handle->count() == 2);
+    }
+
+    GIVEN("an AsyncStore and a slice subscriber")
+    WHEN("a batch of events is dispatched")
+    THEN("the subscriber is notified once with the final slice") {
+        std::vector<int> seen;
+        sut.subscribeSync([](const MyState& state) { return state.value; }, [&](int value) { seen.push_back(value); });
+
+        std::vector<int> batch { 1, 0, 2, 3 };
+        sut.dispatchBatch(batch.begin(), batch.end()).get();
+        CHECK(seen == vector<int>{ 6 });
+        CHECK(sut.state().other == 1);
+    }
 }
@@ -0,0 +1,273 @@
+#include <ReduCxx/StoreFactory.hpp>
+#include <ReduCxx/Async/ThreadPool.hpp>
+#include "../catch.hpp"
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace ReduCxx;
+
+SCENARIO("thread pool") {
+
+    GIVEN("a thread pool")
+    WHEN("tasks are executed")
+    THEN("they all run on the pool workers") {
+        std::mutex mutex;
+        std::set<std::thread::id> threads;
+        std::atomic<int> runs { 0 };
+        {
+            ThreadPool sut(3);
+            CHECK(sut.size() == 3);
+            for (int i = 0; i < 100; ++i) {
+                sut.execute([&]() {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    threads.insert(std::this_thread::get_id());
+                    ++runs;
+                });
+            }
+        }   // the destructor runs the queued tasks
+
+        CHECK(runs == 100);
+        CHECK(threads.size() <= 3);
+        CHECK(threads.count(std::this_thread::get_id()) == 0);
+    }
+
+    GIVEN("a thread pool with an error sink")
+    WHEN("tasks throw")
+    THEN("the exceptions reach the sink") {
+        std::atomic<int> errors { 0 };
+        {
+            ThreadPool sut(2);
+            sut.setErrorSink([&](std::exception_ptr) { ++errors; });
+            for (int i = 0; i < 10; ++i) {
+                sut.execute([i]() {
+                    if (i % 2 == 0) {
+                        throw std::runtime_error("even");
+                    }
+                });
+            }
+        }
+
+        CHECK(errors == 5);
+    }
+
+    GIVEN("a thread pool and a task submitting other tasks")
+    WHEN("it runs")
+    THEN("the tasks it submitted run too") {
+        std::atomic<int> runs { 0 };
+        {
+            ThreadPool sut(2);
+            sut.execute([&]() {
+                for (int i = 0; i < 10; ++i) {
+                    sut.execute([&]() { ++runs; });
+                }
+            });
+            while (runs < 10) {
+                std::this_thread::yield();
+            }
+        }
+
+        CHECK(runs == 10);
+    }
+}
+
+SCENARIO("strands") {
+
+    GIVEN("a strand fed by several threads")
+    WHEN("operations are posted")
+    THEN("they run one at a time, in the order each thread posted them") {
+        ThreadPool pool(4);
+        Strand sut(pool);
+        std::atomic<int> running { 0 };
+        std::atomic<int> overlaps { 0 };
+        std::vector<std::vector<int>> seen(4);      // only touched by the strand
+        std::vector<std::thread> producers;
+        for (int p = 0; p < 4; ++p) {
+            producers.emplace_back([&, p]() {
+                for (int i = 0; i < 500; ++i) {
+                    sut.postDetached([&, p, i]() {
+                        if (running++ != 0) {
+                            ++overlaps;
+                        }
+                        seen[p].push_back(i);
+                        --running;
+                    });
+                }
+            });
+        }
+        for (std::thread& producer : producers) {
+            producer.join();
+        }
+        sut.post([]() {}).get();
+
+        CHECK(overlaps == 0);
+        for (const std::vector<int>& values : seen) {
+            REQUIRE(values.size() == 500);
+            bool ordered = true;
+            for (int i = 0; i < 500; ++i) {
+                ordered = ordered && values[i] == i;
+            }
+            CHECK(ordered);
+        }
+    }
+
+    GIVEN("a strand")
+    WHEN("a posted operation throws")
+    THEN("the exception is rethrown by its future and the strand goes on") {
+        ThreadPool pool(2);
+        Strand sut(pool);
+        std::future<void> failing = sut.post([]() { throw std::runtime_error("strand"); });
+        int after = 0;
+        std::future<void> next = sut.post([&]() { after = 1; });
+
+        CHECK_THROWS_AS(failing.get(), std::runtime_error);
+        next.get();
+        CHECK(after == 1);
+    }
+}
+
+SCENARIO("subscriptions on a thread pool") {
+
+    GIVEN("an async Store and many subscribers sharing a small thread pool")
+    WHEN("actions are dispatched")
+    THEN("each subscriber is notified of every change, in order") {
+        ThreadPool pool(2);
+        auto sut = StoreFactory<int>::makeAsync([](const int& state, const int& action) {
+            return state + action;
+        });
+        constexpr int SUBSCRIBERS = 16;
+        std::vector<std::vector<int>> seen(SUBSCRIBERS);    // each one touched by its own strand only
+        std::vector<std::shared_ptr<SubscriptionHandle>> handles;
+        for (int s = 0; s < SUBSCRIBERS; ++s) {
+            handles.push_back(sut.subscribeAsync(pool, [](const std::tuple<int>& state) { return std::get<0>(state); },
+                                                 [&seen, s](int value) { seen[s].push_back(value); }));
+        }
+
+        for (int i = 0; i < 50; ++i) {
+            sut.dispatch(1);
+        }
+        sut.dispatch(0).get();
+        for (const std::shared_ptr<SubscriptionHandle>& handle : handles) {
+            handle->waitAll();
+        }
+
+        std::vector<int> expected;
+        for (int i = 1; i <= 50; ++i) {
+            expected.push_back(i);
+        }
+        for (const std::vector<int>& values : seen) {
+            CHECK(values == expected);
+        }
+    }
+
+    GIVEN("an async Store and a throwing subscriber on a thread pool")
+    WHEN("an action is dispatched")
+    THEN("the exception is rethrown on wait") {
+        ThreadPool pool(2);
+        auto sut = StoreFactory<int>::makeAsync([](const int& state, const int& action) {
+            return state + action;
+        });
+        std::shared_ptr<SubscriptionHandle> handle = sut.subscribeAsync(pool, []() {
+            throw std::runtime_error("subscriber");
+        });
+
+        sut.dispatch(1).get();
+
+        CHECK(handle->count() == 1);
+        CHECK_THROWS_AS(handle->waitOne(), std::runtime_error);
+    }
+}
+
+SCENARIO("parallel composer") {
+
+    struct Numbers {
+        std::vector<int> values;
+    };
+
+    struct Action {
+        enum TYPE { ADD, FAIL, COUNT };
+        TYPE kind;
+        int value;
+        TYPE type() const { return kind; }
+    };
+
+    auto add = [](const Numbers& state, const Action& action) -> Numbers {
+        if (action.kind == Action::FAIL) {
+            throw std::runtime_error("failing reducer");
+        }
+        Numbers next = state;
+        next.values.push_back(action.value);
+        return next;
+    };
+
+    GIVEN("a Store whose reducers run on a thread pool")
+    WHEN("actions are dispatched")
+    THEN("the state is the same as with sequential reducers") {
+        ThreadPool pool(3);
+        std::atomic<int> counts { 0 };
+        auto sut = StoreFactory<Action>::makeParallel(pool,
+            add,
+            [](const int& state, const Action& action) { return state + action.value; },
+            [](const std::string& state, const Action& action) -> std::optional<std::string> {
+                if (action.value % 2 == 0) {
+                    return std::nullopt;
+                }
+                return state + std::to_string(action.value);
+            },
+            handles<Action::COUNT>([&counts](const long& state, const Action&) {
+                ++counts;
+                return state + 1;
+            }));
+
+        sut.dispatch({ Action::ADD, 1 });
+        sut.dispatch({ Action::ADD, 2 });
+        CHECK(sut.dirty() == 0b0011);
+        sut.dispatch({ Action::COUNT, 3 });
+
+        CHECK(sut.state<0>().values == std::vector<int>{ 1, 2, 3 });
+        CHECK(sut.state<1>() == 6);
+        CHECK(sut.state<2>() == "13");
+        CHECK(sut.state<3>() == 1);
+        CHECK(counts == 1);
+    }
+
+    GIVEN("a Store whose reducers run on a thread pool")
+    WHEN("one of the reducers throws")
+    THEN("the exception is rethrown and no sub-state changes") {
+        ThreadPool pool(2);
+        std::atomic<int> calls { 0 };
+        auto sut = StoreFactory<Action>::makeParallel(pool, HistoryPolicy::bounded(1),
+            [&calls](std::vector<int>& state, const Action& action) {  // in place, yet state is kept
+                ++calls;
+                state.push_back(action.value);
+            },
+            add);
+
+        sut.dispatch({ Action::ADD, 1 });
+        CHECK_THROWS_AS(sut.dispatch({ Action::FAIL, 2 }), std::runtime_error);
+
+        CHECK(calls == 2);
+        CHECK(sut.state<0>() == std::vector<int>{ 1 });
+        CHECK(sut.state<1>().values == std::vector<int>{ 1 });
+    }
+
+    GIVEN("an async Store whose reducers run on a thread pool")
+    WHEN("actions are dispatched")
+    THEN("reducers run in parallel with the reducers thread") {
+        ThreadPool pool(2);
+        auto sut = StoreFactory<Action>::makeParallelAsync(pool,
+            [](const int& state, const Action& action) { return state + action.value; },
+            [](const int& state, const Action& action) { return state - action.value; });
+
+        for (int i = 1; i <= 100; ++i) {
+            sut.dispatch({ Action::ADD, i });
+        }
+        sut.dispatch({ Action::ADD, 0 }).get();
+
+        CHECK(sut.state<0>() == 5050);
+        CHECK(sut.state<1>() == -5050);
+    }
+}
@@ -1,2 +1,3 @@
 #define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#define CATCH_CONFIG_NO_POSIX_SIGNALS // bundled Catch2 predates glibc >= 2.34 dynamic MINSIGSTKSZ
 #include "catch.hpp"